@@ -0,0 +1,709 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 12/07/2025
+ *
+ * btree.c
+ * Implementation of an ordered set of strings using a B-tree of minimum
+ * degree T, so each node holds between T - 1 and MAX_KEYS = 2T - 1 strings.
+ * A leaf is just a count and its array of string pointers, 128 bytes or two
+ * cache lines, and an internal node also keeps its children and the number
+ * of elements under each child, which is what makes rank and select
+ * logarithmic. Nodes are split on the way down during insertion, and
+ * refilled from a sibling or merged on the way down during removal, so
+ * neither ever has to walk back up the tree.
+ *
+ * Big O Time Complexities:
+ * createSet: O(1)
+ * buildSet: O(n log n)
+ * destroySet: O(n)
+ * numElements: O(1)
+ * addElement: O(log n)
+ * removeElement: O(log n)
+ * toggleElement: O(log n)
+ * findElement: O(log n)
+ * getElements: O(n)
+ * firstElement: O(log n)
+ * nextElement: O(log n) worst case, O(1) amortized
+ * rankElement: O(log n)
+ * selectElement: O(log n)
+ * forEachInRange: O(log n + k) where k is the number of elements visited
+ * search: O(log MAX_KEYS)
+ * split: O(MAX_KEYS)
+ * merge: O(MAX_KEYS)
+ * insert: O(log n)
+ * delete: O(log n)
+ * fill: O(n)
+ * dedup: O(n)
+ * build: O(n)
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "set.h"
+#include "order.h"
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#define T 8
+#define MAX_KEYS (2 * T - 1)
+#define MAX_DEPTH 32	/* deeper than any tree of 2^31 elements */
+
+struct links {
+	int sizes[MAX_KEYS + 1];	/* elements under each child */
+	struct node *child[MAX_KEYS + 1];
+};
+
+struct node {
+	int n;				/* number of strings */
+	bool leaf;
+	char *keys[MAX_KEYS];
+	struct links in[];		/* one for an internal node, none for a leaf */
+};
+
+struct place {
+	struct node *node;
+	int i;		/* next string to return, after child i in an internal node */
+};
+
+typedef struct set {
+	size_t count;
+	struct node *root;
+	struct place path[MAX_DEPTH];	/* nodes being visited while iterating */
+	int depth;
+} SET;
+
+/* private helper: allocate an empty node. A leaf is allocated without the
+ * links to children, which it never uses.
+ * Big O: O(1)
+ */
+static struct node *newNode(bool leaf) {
+	struct node *x = malloc(sizeof(struct node) + (leaf ? 0 : sizeof(struct links)));
+	assert(x != NULL);
+	x->n = 0;
+	x->leaf = leaf;
+	return x;
+}
+
+/* private helper: return the index of the first string in node x that is
+ * not less than elt, setting *found to whether it is equal to elt.
+ * Big O: O(log MAX_KEYS)
+ */
+static int search(struct node *x, char *elt, bool *found) {
+	int lo = 0, hi = x->n - 1, mid, diff;
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+		diff = strcmp(elt, x->keys[mid]);
+		if (diff > 0) {
+			lo = mid + 1;
+		}
+		else if (diff < 0) {
+			hi = mid - 1;
+		}
+		else {
+			*found = true;
+			return mid;
+		}
+	}
+	*found = false;
+	return lo;
+}
+
+/* private helper: return the number of elements in the subtree rooted at x.
+ * Big O: O(MAX_KEYS)
+ */
+static int total(struct node *x) {
+	int size = x->n;
+	if (!x->leaf) {
+		for (int i = 0; i <= x->n; i++) {
+			size += x->in->sizes[i];
+		}
+	}
+	return size;
+}
+
+/* private helper: split the full child i of node x into two nodes of T - 1
+ * strings each, moving the middle string up into x.
+ * Big O: O(MAX_KEYS)
+ */
+static void split(struct node *x, int i) {
+	struct node *y = x->in->child[i];
+	struct node *z = newNode(y->leaf);
+	int j;
+	z->n = T - 1;
+	memcpy(z->keys, y->keys + T, sizeof(char*) * (T - 1));
+	if (!y->leaf) {
+		memcpy(z->in->child, y->in->child + T, sizeof(struct node*) * T);
+		memcpy(z->in->sizes, y->in->sizes + T, sizeof(int) * T);
+	}
+	y->n = T - 1;
+	for (j = x->n; j > i; j--) {
+		x->keys[j] = x->keys[j - 1];
+		x->in->child[j + 1] = x->in->child[j];
+		x->in->sizes[j + 1] = x->in->sizes[j];
+	}
+	x->keys[i] = y->keys[T - 1];
+	x->in->child[i + 1] = z;
+	x->in->sizes[i + 1] = total(z);
+	x->in->sizes[i] -= x->in->sizes[i + 1] + 1;
+	x->n++;
+}
+
+/* private helper: merge child i + 1 of node x and the string between them
+ * into child i, where both children have T - 1 strings.
+ * Big O: O(MAX_KEYS)
+ */
+static void merge(struct node *x, int i) {
+	struct node *y = x->in->child[i];
+	struct node *z = x->in->child[i + 1];
+	int j;
+	y->keys[T - 1] = x->keys[i];
+	memcpy(y->keys + T, z->keys, sizeof(char*) * (T - 1));
+	if (!y->leaf) {
+		memcpy(y->in->child + T, z->in->child, sizeof(struct node*) * T);
+		memcpy(y->in->sizes + T, z->in->sizes, sizeof(int) * T);
+	}
+	y->n = MAX_KEYS;
+	x->in->sizes[i] += x->in->sizes[i + 1] + 1;
+	for (j = i + 1; j < x->n; j++) {
+		x->keys[j - 1] = x->keys[j];
+		x->in->child[j] = x->in->child[j + 1];
+		x->in->sizes[j] = x->in->sizes[j + 1];
+	}
+	x->n--;
+	free(z);
+}
+
+/* private helper: move the last string of child i - 1 of node x up into x,
+ * and the string of x between them down into child i, along with the last
+ * child of child i - 1.
+ * Big O: O(MAX_KEYS)
+ */
+static void borrowLeft(struct node *x, int i) {
+	struct node *y = x->in->child[i - 1];
+	struct node *z = x->in->child[i];
+	int moved = 1;
+	memmove(z->keys + 1, z->keys, sizeof(char*) * z->n);
+	z->keys[0] = x->keys[i - 1];
+	x->keys[i - 1] = y->keys[y->n - 1];
+	if (!z->leaf) {
+		memmove(z->in->child + 1, z->in->child, sizeof(struct node*) * (z->n + 1));
+		memmove(z->in->sizes + 1, z->in->sizes, sizeof(int) * (z->n + 1));
+		z->in->child[0] = y->in->child[y->n];
+		z->in->sizes[0] = y->in->sizes[y->n];
+		moved += z->in->sizes[0];
+	}
+	y->n--;
+	z->n++;
+	x->in->sizes[i - 1] -= moved;
+	x->in->sizes[i] += moved;
+}
+
+/* private helper: move the first string of child i + 1 of node x up into x,
+ * and the string of x between them down into child i, along with the
+ * first child of child i + 1.
+ * Big O: O(MAX_KEYS)
+ */
+static void borrowRight(struct node *x, int i) {
+	struct node *y = x->in->child[i];
+	struct node *z = x->in->child[i + 1];
+	int moved = 1;
+	y->keys[y->n] = x->keys[i];
+	x->keys[i] = z->keys[0];
+	memmove(z->keys, z->keys + 1, sizeof(char*) * (z->n - 1));
+	if (!y->leaf) {
+		y->in->child[y->n + 1] = z->in->child[0];
+		y->in->sizes[y->n + 1] = z->in->sizes[0];
+		moved += z->in->sizes[0];
+		memmove(z->in->child, z->in->child + 1, sizeof(struct node*) * z->n);
+		memmove(z->in->sizes, z->in->sizes + 1, sizeof(int) * z->n);
+	}
+	y->n++;
+	z->n--;
+	x->in->sizes[i] += moved;
+	x->in->sizes[i + 1] -= moved;
+}
+
+/* private helper: add elt, which is known to be absent, to the tree. A full
+ * root is split first, growing the tree by one level, and each full child
+ * is split before descending into it, so there is always room in the leaf.
+ * Big O: O(log n)
+ */
+static void insert(SET *sp, char *elt) {
+	struct node *x = sp->root;
+	bool found;
+	int i;
+	if (x->n == MAX_KEYS) {
+		struct node *s = newNode(false);
+		s->in->child[0] = x;
+		s->in->sizes[0] = sp->count;
+		split(s, 0);
+		sp->root = x = s;
+	}
+	while (!x->leaf) {
+		i = search(x, elt, &found);
+		if (x->in->child[i]->n == MAX_KEYS) {
+			split(x, i);
+			if (strcmp(elt, x->keys[i]) > 0) {
+				i++;
+			}
+		}
+		x->in->sizes[i]++;
+		x = x->in->child[i];
+	}
+	i = search(x, elt, &found);
+	memmove(x->keys + i + 1, x->keys + i, sizeof(char*) * (x->n - i));
+	x->keys[i] = elt;
+	x->n++;
+	sp->count++;
+}
+
+/* private helper: return the largest string in the subtree rooted at x.
+ * Big O: O(log n)
+ */
+static char *maximum(struct node *x) {
+	while (!x->leaf) {
+		x = x->in->child[x->n];
+	}
+	return x->keys[x->n - 1];
+}
+
+/* private helper: return the smallest string in the subtree rooted at x.
+ * Big O: O(log n)
+ */
+static char *minimum(struct node *x) {
+	while (!x->leaf) {
+		x = x->in->child[0];
+	}
+	return x->keys[0];
+}
+
+/* private helper: remove the string equal to elt, which is known to be
+ * present, from the subtree rooted at x, which has at least T strings unless
+ * it is the root, and return the stored string. A child is given at least
+ * T strings before descending into it, by borrowing from a sibling or by
+ * merging with one. A string found in an internal node is replaced by its
+ * predecessor or successor, which is removed from the child instead.
+ * Big O: O(log n)
+ */
+static char *delete(struct node *x, char *elt) {
+	bool found;
+	char *removed, *other;
+	int i = search(x, elt, &found);
+	if (found && x->leaf) {
+		removed = x->keys[i];
+		memmove(x->keys + i, x->keys + i + 1, sizeof(char*) * (x->n - i - 1));
+		x->n--;
+		return removed;
+	}
+	if (found) {
+		removed = x->keys[i];
+		if (x->in->child[i]->n >= T) {
+			other = maximum(x->in->child[i]);
+			x->in->sizes[i]--;
+			x->keys[i] = delete(x->in->child[i], other);
+			return removed;
+		}
+		if (x->in->child[i + 1]->n >= T) {
+			other = minimum(x->in->child[i + 1]);
+			x->in->sizes[i + 1]--;
+			x->keys[i] = delete(x->in->child[i + 1], other);
+			return removed;
+		}
+		merge(x, i);
+		x->in->sizes[i]--;
+		return delete(x->in->child[i], elt);
+	}
+	assert(!x->leaf);
+	if (x->in->child[i]->n == T - 1) {
+		if (i > 0 && x->in->child[i - 1]->n >= T) {
+			borrowLeft(x, i);
+		}
+		else if (i < x->n && x->in->child[i + 1]->n >= T) {
+			borrowRight(x, i);
+		}
+		else if (i < x->n) {
+			merge(x, i);
+		}
+		else {
+			merge(x, --i);
+		}
+	}
+	x->in->sizes[i]--;
+	return delete(x->in->child[i], elt);
+}
+
+/* private helper: free every node of the subtree rooted at x and the strings
+ * in them.
+ * Big O: O(n)
+ */
+static void destroyNode(struct node *x) {
+	for (int i = 0; i < x->n; i++) {
+		free(x->keys[i]);
+	}
+	if (!x->leaf) {
+		for (int i = 0; i <= x->n; i++) {
+			destroyNode(x->in->child[i]);
+		}
+	}
+	free(x);
+}
+
+/* private helper: return the stored string equal to elt, or NULL if there is
+ * none.
+ * Big O: O(log n)
+ */
+static char *lookup(SET *sp, char *elt) {
+	struct node *x = sp->root;
+	bool found;
+	int i;
+	while (true) {
+		i = search(x, elt, &found);
+		if (found) {
+			return x->keys[i];
+		}
+		if (x->leaf) {
+			return NULL;
+		}
+		x = x->in->child[i];
+	}
+}
+
+/* private helper: remove the stored string equal to elt, which is known to
+ * be present, and free it. An empty internal root is replaced by its only
+ * child, shrinking the tree by one level.
+ * Big O: O(log n)
+ */
+static void removeKnown(SET *sp, char *elt) {
+	struct node *x = sp->root;
+	free(delete(x, elt));
+	sp->count--;
+	if (x->n == 0 && !x->leaf) {
+		sp->root = x->in->child[0];
+		free(x);
+	}
+}
+
+/* createSet: allocate and initialize a new SET with an empty root. The tree
+ * grows as needed, so maxElts is only checked.
+ * Big O: O(1)
+ */
+SET *createSet(int maxElts) {
+	SET *sp;
+	assert(maxElts > 0);
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	sp->count = 0;
+	sp->depth = 0;
+	sp->root = newNode(true);
+	return sp;
+}
+
+/* private helper: compare the strings pointed to by a and b, for qsort.
+ * Big O: O(1)
+ */
+static int compare(const void *a, const void *b) {
+	return strcmp(*(char**)a, *(char**)b);
+}
+
+/* private helper: remove adjacent duplicates from the sorted array elts of n
+ * strings, freeing them, and return the number of strings left.
+ * Big O: O(n)
+ */
+static int dedup(char **elts, int n) {
+	int count = 0;
+	for (int i = 0; i < n; i++) {
+		if (count > 0 && strcmp(elts[i], elts[count - 1]) == 0) {
+			free(elts[i]);
+		}
+		else {
+			elts[count++] = elts[i];
+		}
+	}
+	return count;
+}
+
+/* private helper: return a subtree holding the n sorted strings of elts,
+ * where cap is the most a tree of the chosen height can hold. The root gets
+ * the fewest children that can hold the strings and they are split as evenly
+ * as possible, which leaves every child at least half full, so no node ends
+ * up with fewer than T - 1 strings.
+ * Big O: O(n)
+ */
+static struct node *build(char **elts, int n, long cap) {
+	struct node *x = newNode(cap == MAX_KEYS);
+	if (x->leaf) {
+		memcpy(x->keys, elts, sizeof(char*) * n);
+		x->n = n;
+		return x;
+	}
+	long below = (cap + 1) / (2 * T) - 1;
+	int c = (n + 1 + below) / (below + 1);
+	int spread = n - (c - 1);
+	for (int i = 0; i < c; i++) {
+		int m = spread / c + (i < spread % c);
+		x->in->child[i] = build(elts, m, below);
+		x->in->sizes[i] = m;
+		elts += m;
+		if (i < c - 1) {
+			x->keys[i] = *elts++;
+		}
+	}
+	x->n = c - 1;
+	return x;
+}
+
+/* buildSet: return a new SET holding the distinct strings of elts, an
+ * unsorted array of n strings. The strings are sorted and the tree is built
+ * bottom up, instead of by n separate insertions. The set takes the strings,
+ * which must have been allocated with malloc, and frees the array and any
+ * duplicates. The tree grows as needed, so maxElts is only checked.
+ * Big O: O(n log n)
+ */
+SET *buildSet(char **elts, int n, int maxElts) {
+	SET *sp;
+	long cap = MAX_KEYS;
+	assert((elts != NULL) && (n >= 0) && (maxElts > 0));
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	qsort(elts, n, sizeof(char*), compare);
+	sp->count = dedup(elts, n);
+	sp->depth = 0;
+	while (cap < sp->count) {
+		cap = (cap + 1) * 2 * T - 1;
+	}
+	sp->root = build(elts, sp->count, cap);
+	free(elts);
+	return sp;
+}
+
+/* destroySet: free all strings owned by the set, the nodes, and the set
+ * structure.
+ * Big O: O(n)
+ */
+void destroySet(SET *sp) {
+	assert(sp != NULL);
+	destroyNode(sp->root);
+	free(sp);
+}
+
+/* numElements: return the number of elements stored
+ * Big O: O(1)
+ */
+int numElements(SET *sp) {
+	assert(sp != NULL);
+	return sp->count;
+}
+
+/* addElement: insert a copy of elt in the set if it is not present.
+ * Big O: O(log n)
+ */
+void addElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	if (lookup(sp, elt) == NULL) {
+		char *newElt = strdup(elt);
+		assert(newElt != NULL);
+		insert(sp, newElt);
+	}
+}
+
+/* removeElement: remove elt if present.
+ * Big O: O(log n)
+ */
+void removeElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	if (lookup(sp, elt) != NULL) {
+		removeKnown(sp, elt);
+	}
+}
+
+/* toggleElement: insert a copy of elt if it is not present, or remove it if
+ * it is. Returns true if elt was inserted.
+ * Big O: O(log n)
+ */
+bool toggleElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	if (lookup(sp, elt) != NULL) {
+		removeKnown(sp, elt);
+		return false;
+	}
+	char *newElt = strdup(elt);
+	assert(newElt != NULL);
+	insert(sp, newElt);
+	return true;
+}
+
+/* findElement: return pointer to stored string equal to elt, or NULL if not
+ * found.
+ * Big O: O(log n)
+ */
+char *findElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	return lookup(sp, elt);
+}
+
+/* private helper: store the strings of the subtree rooted at x in sorted
+ * order starting at elts, and return the position after the last one.
+ * Big O: O(n)
+ */
+static char **fill(struct node *x, char **elts) {
+	for (int i = 0; i <= x->n; i++) {
+		if (!x->leaf) {
+			elts = fill(x->in->child[i], elts);
+		}
+		if (i < x->n) {
+			*elts++ = x->keys[i];
+		}
+	}
+	return elts;
+}
+
+/* getElements: return a newly-allocated array of pointers to the elements
+ * stored in the set, in sorted order.
+ * Big O: O(n)
+ */
+char **getElements(SET *sp) {
+	assert(sp != NULL);
+	char **cpy;
+	cpy = malloc(sp->count*sizeof(char *));
+	assert(cpy != NULL);
+	fill(sp->root, cpy);
+	return cpy;
+}
+
+/* private helper: push x and the leftmost path below it onto the iteration
+ * path of the set.
+ * Big O: O(log n)
+ */
+static void descend(SET *sp, struct node *x) {
+	while (true) {
+		assert(sp->depth < MAX_DEPTH);
+		sp->path[sp->depth].node = x;
+		sp->path[sp->depth].i = 0;
+		sp->depth++;
+		if (x->leaf) {
+			return;
+		}
+		x = x->in->child[0];
+	}
+}
+
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The elements are
+ * visited in place in sorted order, without allocating, by keeping the
+ * path from the root to the current node. The set must not be changed
+ * until nextElement returns NULL.
+ * Big O: O(log n)
+ */
+char *firstElement(SET *sp) {
+	assert(sp != NULL);
+	sp->depth = 0;
+	descend(sp, sp->root);
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned. After an
+ * internal node's string is returned, the path continues down the leftmost
+ * side of the next child.
+ * Big O: O(log n) worst case, O(1) amortized
+ */
+char *nextElement(SET *sp) {
+	assert(sp != NULL);
+	while (sp->depth > 0) {
+		struct place *p = &sp->path[sp->depth - 1];
+		if (p->i < p->node->n) {
+			char *elt = p->node->keys[p->i++];
+			if (!p->node->leaf) {
+				descend(sp, p->node->in->child[p->i]);
+			}
+			return elt;
+		}
+		sp->depth--;
+	}
+	return NULL;
+}
+
+/* rankElement: return the number of elements in the set less than elt,
+ * which is the position of elt in sorted order if it is present.
+ * Big O: O(log n)
+ */
+int rankElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	struct node *x = sp->root;
+	bool found;
+	int i, rank = 0;
+	while (true) {
+		i = search(x, elt, &found);
+		rank += i;
+		if (!x->leaf) {
+			for (int j = 0; j < i; j++) {
+				rank += x->in->sizes[j];
+			}
+		}
+		if (x->leaf) {
+			return rank;
+		}
+		if (found) {
+			return rank + x->in->sizes[i];
+		}
+		x = x->in->child[i];
+	}
+}
+
+/* selectElement: return the element at position k in sorted order, counting
+ * from 0, or NULL if k is out of range.
+ * Big O: O(log n)
+ */
+char *selectElement(SET *sp, int k) {
+	assert(sp != NULL);
+	struct node *x = sp->root;
+	int i;
+	if (k < 0 || k >= sp->count) {
+		return NULL;
+	}
+	while (!x->leaf) {
+		for (i = 0; k >= x->in->sizes[i]; i++) {
+			k -= x->in->sizes[i];
+			if (k == 0) {
+				return x->keys[i];
+			}
+			k--;
+		}
+		x = x->in->child[i];
+	}
+	return x->keys[k];
+}
+
+/* private helper: call visit(elt, arg) on each string in the subtree rooted
+ * at x from lo to hi inclusive, in sorted order, where a NULL bound is
+ * unlimited. Returns the number of strings visited.
+ * Big O: O(log n + k) where k is the number of strings visited
+ */
+static int visitRange(struct node *x, char *lo, char *hi, void (*visit)(), void *arg) {
+	bool found;
+	int i = lo != NULL ? search(x, lo, &found) : 0;
+	int visited = 0;
+	for (;; i++) {
+		if (!x->leaf) {
+			visited += visitRange(x->in->child[i], lo, hi, visit, arg);
+		}
+		if (i == x->n || (hi != NULL && strcmp(x->keys[i], hi) > 0)) {
+			return visited;
+		}
+		(*visit)(x->keys[i], arg);
+		visited++;
+	}
+}
+
+/* forEachInRange: call visit(elt, arg) on each element from lo to hi
+ * inclusive, in sorted order, where a NULL bound is unlimited, and return
+ * the number of elements visited. Only the subtrees that can hold such
+ * elements are entered.
+ * Big O: O(log n + k) where k is the number of elements visited
+ */
+int forEachInRange(SET *sp, char *lo, char *hi, void (*visit)(), void *arg) {
+	assert((sp != NULL) && (visit != NULL));
+	return visitRange(sp->root, lo, hi, visit, arg);
+}
@@ -0,0 +1,122 @@
+/*
+ * File:        bulk.c
+ *
+ * Copyright:	2021, Darren C. Atkinson
+ *
+ * Description: This file contains the main function for testing a set
+ *              abstract data type for strings built in bulk.
+ *
+ *              The program behaves like unique, except that the words in
+ *              the first file are read into an array and the set is built
+ *              from the whole array at once by buildSet, rather than by
+ *              inserting them one at a time.  If the second file is
+ *              given then all words in the second file are deleted from
+ *              the set and the count printed.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include "order.h"
+
+
+/* This is sufficient for the test cases in /scratch/coen12. */
+
+# define MAX_SIZE 18000
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the test application.
+ */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    char buffer[BUFSIZ], *word, **elts;
+    SET *unique;
+    int i, words, length;
+    bool lflag = false;
+
+
+    /* Check usage and open the first file. */
+
+    if (argc > 1 && strcmp(argv[1], "-l") == 0) {
+	lflag = true;
+	argc --;
+
+	for (i = 1; i < argc; i ++)
+	    argv[i] = argv[i + 1];
+    }
+
+    if (argc == 1 || argc > 3) {
+        fprintf(stderr, "usage: %s [-l] file1 [file2]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp = fopen(argv[1], "r")) == NULL) {
+        fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+        exit(EXIT_FAILURE);
+    }
+
+
+    /* Read all words into an array, doubling it as needed, and build the
+       set from it. */
+
+    words = 0;
+    length = MAX_SIZE;
+    elts = malloc(sizeof(char *) * length);
+
+    while (fscanf(fp, "%s", buffer) == 1) {
+	if (words == length) {
+	    length *= 2;
+	    elts = realloc(elts, sizeof(char *) * length);
+	}
+
+	if (elts == NULL || (elts[words ++] = strdup(buffer)) == NULL) {
+	    fprintf(stderr, "%s: out of memory\n", argv[0]);
+	    exit(EXIT_FAILURE);
+	}
+    }
+
+    fclose(fp);
+    unique = buildSet(elts, words, MAX_SIZE);
+
+    if (!lflag) {
+	printf("%d total words\n", words);
+	printf("%d distinct words\n", numElements(unique));
+    }
+
+
+    /* Try to open the second file. */
+
+    if (argc == 3) {
+        if ((fp = fopen(argv[2], "r")) == NULL) {
+            fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[2]);
+            exit(EXIT_FAILURE);
+        }
+
+
+        /* Delete all words in the second file. */
+
+        while (fscanf(fp, "%s", buffer) == 1)
+            removeElement(unique, buffer);
+
+	fclose(fp);
+
+	if (!lflag)
+	    printf("%d remaining words\n", numElements(unique));
+    }
+
+
+    /* Print the list of words if desired. */
+
+    if (lflag)
+	for (word = firstElement(unique); word != NULL; word = nextElement(unique))
+	    printf("%s\n", word);
+
+    destroySet(unique);
+    exit(EXIT_SUCCESS);
+}
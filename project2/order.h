@@ -0,0 +1,23 @@
+/*
+ * File:        order.h
+ *
+ * Description: This file contains the public function declarations for
+ *              ordered queries on, and bulk construction of, a set
+ *              abstract data type for strings whose elements are kept in
+ *              sorted order.
+ */
+
+# ifndef ORDER_H
+# define ORDER_H
+
+# include "set.h"
+
+SET *buildSet(char **elts, int n, int maxElts);
+
+int rankElement(SET *sp, char *elt);
+
+char *selectElement(SET *sp, int k);
+
+int forEachInRange(SET *sp, char *lo, char *hi, void (*visit)(), void *arg);
+
+# endif /* ORDER_H */
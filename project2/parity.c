@@ -57,11 +57,7 @@ int main(int argc, char *argv[])
 
     while (fscanf(fp, "%s", buffer) == 1) {
         words ++;
-
-        if (findElement(odd, buffer))
-            removeElement(odd, buffer);
-        else
-            addElement(odd, buffer);
+        toggleElement(odd, buffer);
     }
 
     printf("%d total words\n", words);
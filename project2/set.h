@@ -11,6 +11,8 @@
 # ifndef SET_H
 # define SET_H
 
+# include <stdbool.h>
+
 typedef struct set SET;
 
 SET *createSet(int maxElts);
@@ -23,8 +25,14 @@ void addElement(SET *sp, char *elt);
 
 void removeElement(SET *sp, char *elt);
 
+bool toggleElement(SET *sp, char *elt);
+
 char *findElement(SET *sp, char *elt);
 
 char **getElements(SET *sp);
 
+char *firstElement(SET *sp);
+
+char *nextElement(SET *sp);
+
 # endif /* SET_H */
@@ -6,36 +6,72 @@
  *
  * sorted.c
  * Implementation of an ordered set of strings.
+ * New strings are appended to a small unsorted buffer instead of being
+ * shifted into place one at a time. Once the buffer holds a fraction of the
+ * square root of the capacity it is sorted and merged into the sorted array
+ * in a single pass, as are any buffered strings before an ordered operation.
+ * Next to the array is an array of the first eight bytes of each string as
+ * a big-endian integer, so most of a binary search compares integers in one
+ * array instead of following a pointer to a different string at each step.
  *
  * Big O Time Complexities:
- * createSet: O(1)
+ * createSet: O(sqrt n)
+ * buildSet: O(n log n)
  * destroySet: O(n)
  * numElements: O(1)
- * addElement: O(n) 
+ * addElement: O(sqrt n) amortized
  * removeElement: O(n)
- * findElement: O(log n)
+ * toggleElement: O(n), O(sqrt n) amortized when inserting
+ * findElement: O(log n + sqrt n)
  * getElements: O(n)
+ * firstElement: O(1), O(n) if strings are buffered
+ * nextElement: O(1)
+ * rankElement: O(log n), O(n) if strings are buffered
+ * selectElement: O(1), O(n) if strings are buffered
+ * forEachInRange: O(log n + k) where k is the number of elements visited,
+ *	O(n) if strings are buffered
  * search: O(log n)
+ * prefixOf: O(1)
+ * lowerBound: O(log n)
+ * buffered: O(sqrt n)
+ * append: O(1) amortized, O(n) when the buffer is full
+ * flush: O(n)
+ * dedup: O(n)
  */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include "set.h"
+#include "order.h"
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef struct set {
-	size_t count;
+	size_t count;		/* strings in data, not counting the buffer */
 	size_t length;
 	char **data;
+	uint64_t *prefix;	/* prefixOf each string in data */
+	size_t cursor;
+	char **buffer;		/* unsorted strings not yet merged into data */
+	size_t pending;
+	size_t limit;		/* merge once the buffer holds this many */
 } SET;
 
-static int search(SET *sp, char *elt, bool *found);
+static int search(SET *sp, size_t n, char *elt, bool *found);
+static uint64_t prefixOf(char *elt);
+static size_t lowerBound(uint64_t *keys, size_t n, uint64_t key);
+static int buffered(SET *sp, char *elt);
+static void append(SET *sp, char *elt);
+static void flush(SET *sp);
+static void createBuffer(SET *sp);
+static int compare(const void *a, const void *b);
+static int dedup(char **elts, int n);
 
 /* createSet: allocate and initialize a new SET holding up to
- * maxElts elements.
- * Big O: O(1)
+ * maxElts elements, with an insert buffer of about sqrt(maxElts) entries.
+ * Big O: O(sqrt n)
  */
 SET *createSet(int maxElts) {
 	SET *sp;
@@ -44,8 +80,37 @@ SET *createSet(int maxElts) {
 	assert(maxElts > 0);
 	sp->count = 0;
 	sp->length = maxElts;
+	sp->cursor = 0;
 	sp->data = malloc(sizeof(char*) * maxElts);
-	assert(sp->data != NULL);
+	sp->prefix = malloc(sizeof(uint64_t) * maxElts);
+	assert((sp->data != NULL) && (sp->prefix != NULL));
+	createBuffer(sp);
+	return sp;
+}
+
+/* buildSet: return a new SET holding the distinct strings of elts, an
+ * unsorted array of n strings, with room for maxElts elements or for all of
+ * them if that is more. The array is sorted and adopted as the set's own, so
+ * it and its strings must have been allocated with malloc, and duplicates
+ * are freed. This avoids the shifting of adding the strings one at a time.
+ * Big O: O(n log n)
+ */
+SET *buildSet(char **elts, int n, int maxElts) {
+	SET *sp;
+	assert((elts != NULL) && (n >= 0) && (maxElts > 0));
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	qsort(elts, n, sizeof(char*), compare);
+	sp->count = dedup(elts, n);
+	sp->length = sp->count > maxElts ? sp->count : maxElts;
+	sp->cursor = 0;
+	sp->data = realloc(elts, sizeof(char*) * sp->length);
+	sp->prefix = malloc(sizeof(uint64_t) * sp->length);
+	assert((sp->data != NULL) && (sp->prefix != NULL));
+	for (int i = 0; i < sp->count; i++) {
+		sp->prefix[i] = prefixOf(sp->data[i]);
+	}
+	createBuffer(sp);
 	return sp;
 }
 
@@ -58,7 +123,12 @@ void destroySet(SET *sp) {
 	for (int i = 0; i < sp->count; i++) {
 		free(sp->data[i]);
 	}
+	for (int i = 0; i < sp->pending; i++) {
+		free(sp->buffer[i]);
+	}
 	free(sp->data);
+	free(sp->prefix);
+	free(sp->buffer);
 	free(sp);
 }
 
@@ -67,55 +137,88 @@ void destroySet(SET *sp) {
  */
 int numElements(SET *sp) {
 	assert(sp != NULL);
-	return sp->count;
+	return sp->count + sp->pending;
 }
 
-/* addElement: insert elt in the set and keep the set sorted.
- * Big O: O(n)
+/* addElement: insert elt in the set if it is not present, by appending it to
+ * the buffer. The sorted array is only shifted when the buffer is merged.
+ * Big O: O(sqrt n) amortized
  */
 void addElement(SET *sp, char *elt) {
-	assert((elt != NULL) && (sp != NULL) && (sp->count < sp->length));	
+	assert((elt != NULL) && (sp != NULL) && (sp->count + sp->pending < sp->length));	
 	bool found;
-	int idx = search(sp, elt, &found);
-	if (!found) {
+	search(sp, sp->count, elt, &found);
+	if (!found && buffered(sp, elt) < 0) {
 		char* newElt = strdup(elt);
 		assert(newElt != NULL);
-		for (int i = sp->count; i > idx; i--) {
-			sp->data[i] = sp->data[i-1];
-		}
-		sp->data[idx] = newElt;
-		sp->count++;
+		append(sp, newElt);
 	}
 }
 
-/* removeElement: remove elt if present and keep the set sorted.
+/* removeElement: remove elt if present and keep the set sorted. A buffered
+ * string is replaced by the last one in the buffer.
  * Big O: O(n)
  */
 void removeElement(SET *sp, char *elt) {
 	assert((sp != NULL) && (elt != NULL));
 	bool found;
-	int idx = search(sp, elt, &found);
+	int idx = search(sp, sp->count, elt, &found);
+	if (found) {
+		free(sp->data[idx]);
+		for (int i = idx+1; i < sp->count; i++) {
+			sp->data[i-1] = sp->data[i];
+			sp->prefix[i-1] = sp->prefix[i];
+		}
+		sp->count--;
+	}
+	else if ((idx = buffered(sp, elt)) >= 0) {
+		free(sp->buffer[idx]);
+		sp->buffer[idx] = sp->buffer[--sp->pending];
+	}
+}
+
+/* toggleElement: insert a copy of elt if it is not present, or remove it if
+ * it is, with a single binary search. Returns true if elt was inserted.
+ * Big O: O(n), O(sqrt n) amortized when inserting
+ */
+bool toggleElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int idx = search(sp, sp->count, elt, &found);
 	if (found) {
 		free(sp->data[idx]);
 		for (int i = idx+1; i < sp->count; i++) {
 			sp->data[i-1] = sp->data[i];
+			sp->prefix[i-1] = sp->prefix[i];
 		}
 		sp->count--;
+		return false;
 	}
+	if ((idx = buffered(sp, elt)) >= 0) {
+		free(sp->buffer[idx]);
+		sp->buffer[idx] = sp->buffer[--sp->pending];
+		return false;
+	}
+	assert(sp->count + sp->pending < sp->length);
+	char* newElt = strdup(elt);
+	assert(newElt != NULL);
+	append(sp, newElt);
+	return true;
 }
 
 /* findElement: return pointer to stored string equal to elt, or NULL if not
- * found.
- * Big O: O(log n)
+ * found. The sorted array is searched first, then the buffer.
+ * Big O: O(log n + sqrt n)
  */
 char *findElement(SET *sp, char *elt) {
 	assert((sp != NULL) && (elt != NULL));
 	bool found;
-	int idx = search(sp, elt, &found);
-	if (!found) {
-		return NULL;
+	int idx = search(sp, sp->count, elt, &found);
+	if (found) {
+		return sp->data[idx];
 	}
-	return sp->data[idx];
+	idx = buffered(sp, elt);
+	return idx >= 0 ? sp->buffer[idx] : NULL;
 }
 
 /* getElements: return a newly-allocated array of pointers to the elements stored in the set.
@@ -123,6 +226,7 @@ char *findElement(SET *sp, char *elt) {
 */
 char **getElements(SET *sp) {
 	assert(sp != NULL);
+	flush(sp);
 	char **cpy;
 	cpy = malloc(sp->count*sizeof(char *));
 	assert(cpy != NULL);
@@ -130,28 +234,232 @@ char **getElements(SET *sp) {
 	return cpy;
 }
 
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The elements are
+ * visited in place in sorted order, without allocating. The set must not be changed
+ * until nextElement returns NULL.
+ * Big O: O(1)
+ */
+char *firstElement(SET *sp) {
+	assert(sp != NULL);
+	flush(sp);
+	sp->cursor = 0;
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned.
+ * Big O: O(1)
+ */
+char *nextElement(SET *sp) {
+	assert(sp != NULL);
+	if (sp->cursor < sp->count) {
+		return sp->data[sp->cursor++];
+	}
+	return NULL;
+}
 
-/* private helper: returns the index of element in set or the index where you would insert it, found using binary search algorithm 
+/* rankElement: return the number of elements in the set less than elt,
+ * which is the position of elt in sorted order if it is present.
  * Big O: O(log n)
  */
-static int search(SET *sp, char *elt, bool *found) {
+int rankElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	flush(sp);
+	bool found;
+	return search(sp, sp->count, elt, &found);
+}
+
+/* selectElement: return the element at position k in sorted order, counting
+ * from 0, or NULL if k is out of range.
+ * Big O: O(1)
+ */
+char *selectElement(SET *sp, int k) {
 	assert(sp != NULL);
-	int lo, hi, mid; lo = 0; hi = sp->count-1;
-	
-	while (lo <= hi) {
-		mid = (lo + hi)/2;	
-		int strDiff = strcmp(elt, sp->data[mid]);
+	flush(sp);
+	if (k < 0 || k >= sp->count) {
+		return NULL;
+	}
+	return sp->data[k];
+}
+
+/* forEachInRange: call visit(elt, arg) on each element from lo to hi
+ * inclusive, in sorted order, where a NULL bound is unlimited, and return
+ * the number of elements visited. The start is found by binary search.
+ * Big O: O(log n + k) where k is the number of elements visited
+ */
+int forEachInRange(SET *sp, char *lo, char *hi, void (*visit)(), void *arg) {
+	assert((sp != NULL) && (visit != NULL));
+	flush(sp);
+	bool found;
+	int i = lo != NULL ? search(sp, sp->count, lo, &found) : 0;
+	int visited = 0;
+	for (; i < sp->count && (hi == NULL || strcmp(sp->data[i], hi) <= 0); i++) {
+		(*visit)(sp->data[i], arg);
+		visited++;
+	}
+	return visited;
+}
+
+
+/* private helper: returns the index of elt among the first n strings in the
+ * set, or the index where you would insert it. The strings with the same
+ * prefix as elt are found by binary search of the prefixes, and only they
+ * are compared with strcmp, past the prefix. A prefix ending in a null byte
+ * is a whole string, so then no strcmp is needed at all.
+ * Big O: O(log n)
+ */
+static int search(SET *sp, size_t n, char *elt, bool *found) {
+	uint64_t key = prefixOf(elt);
+	size_t lo = lowerBound(sp->prefix, n, key), hi, mid;
+	*found = false;
+	if (lo == n || sp->prefix[lo] != key) {
+		return lo;
+	}
+	if ((key & 0xff) == 0) {
+		*found = true;
+		return lo;
+	}
+	hi = key == UINT64_MAX ? n : lo + lowerBound(sp->prefix + lo, n - lo, key + 1);
+	while (lo < hi) {
+		mid = (lo + hi)/2;
+		int strDiff = strcmp(elt + 8, sp->data[mid] + 8);
 		if (strDiff > 0) {
 			lo = mid + 1;
 		}
 		else if (strDiff < 0) {
-			hi = mid -1;
+			hi = mid;
 		}
 		else {
-			*found = true; 
+			*found = true;
 			return mid;
 		}
 	}
-	*found = false; 
 	return lo;
 }
+
+/* private helper: returns the first eight bytes of elt as a big-endian
+ * integer, padded with null bytes, so that comparing prefixes as integers
+ * orders them the same way strcmp would.
+ * Big O: O(1)
+ */
+static uint64_t prefixOf(char *elt) {
+	uint64_t key = 0;
+	for (int i = 0; i < 8 && elt[i] != '\0'; i++) {
+		key |= (uint64_t) (unsigned char) elt[i] << (56 - 8 * i);
+	}
+	return key;
+}
+
+/* private helper: returns the index of the first of the n sorted keys that
+ * is not less than key. The range is halved by adding the result of the
+ * comparison times half its size rather than branching on it, so there
+ * are no mispredicted branches to wait on. Without a branch the processor
+ * cannot guess ahead, so both places the next step might look are
+ * prefetched instead.
+ * Big O: O(log n)
+ */
+static size_t lowerBound(uint64_t *keys, size_t n, uint64_t key) {
+	uint64_t *base = keys;
+	if (n == 0) {
+		return 0;
+	}
+	while (n > 1) {
+		size_t half = n / 2;
+		__builtin_prefetch(base + half / 2);
+		__builtin_prefetch(base + half + half / 2);
+		base += (base[half - 1] < key) * half;
+		n -= half;
+	}
+	return (base - keys) + (*base < key);
+}
+
+/* private helper: returns the index of elt in the buffer, or -1 if it is not
+ * there, found by a linear scan.
+ * Big O: O(sqrt n)
+ */
+static int buffered(SET *sp, char *elt) {
+	for (int i = 0; i < sp->pending; i++) {
+		if (strcmp(elt, sp->buffer[i]) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* private helper: append elt, which is in neither the array nor the buffer,
+ * to the buffer, merging the buffer into the array once it is full.
+ * Big O: O(1) amortized, O(n) when the buffer is full
+ */
+static void append(SET *sp, char *elt) {
+	sp->buffer[sp->pending++] = elt;
+	if (sp->pending == sp->limit) {
+		flush(sp);
+	}
+}
+
+/* private helper: sort the buffer and merge it into the sorted array,
+ * working back from the largest buffered string. Each one is placed by a
+ * binary search of the part of the array not yet moved, and the run of
+ * strings above it and their prefixes are moved up with a memmove each, so
+ * each string in the array moves only once.
+ * Big O: O(n)
+ */
+static void flush(SET *sp) {
+	if (sp->pending == 0) {
+		return;
+	}
+	qsort(sp->buffer, sp->pending, sizeof(char*), compare);
+	int end = sp->count;
+	bool found;
+	for (int j = sp->pending - 1; j >= 0; j--) {
+		int lo = search(sp, end, sp->buffer[j], &found);
+		memmove(sp->data + lo + j + 1, sp->data + lo, sizeof(char*) * (end - lo));
+		memmove(sp->prefix + lo + j + 1, sp->prefix + lo, sizeof(uint64_t) * (end - lo));
+		sp->data[lo + j] = sp->buffer[j];
+		sp->prefix[lo + j] = prefixOf(sp->buffer[j]);
+		end = lo;
+	}
+	sp->count += sp->pending;
+	sp->pending = 0;
+}
+
+/* private helper: allocate an empty buffer holding a quarter of the square
+ * root of the capacity. A bigger buffer means fewer merges but a longer scan
+ * on every insertion and lookup, and a merge is mostly one memmove, so the
+ * buffer is kept smaller than the square root itself.
+ * Big O: O(sqrt n)
+ */
+static void createBuffer(SET *sp) {
+	sp->limit = 1;
+	while (4 * sp->limit * 4 * sp->limit < sp->length) {
+		sp->limit++;
+	}
+	sp->pending = 0;
+	sp->buffer = malloc(sizeof(char*) * sp->limit);
+	assert(sp->buffer != NULL);
+}
+
+/* private helper: compare the strings pointed to by a and b, for qsort.
+ * Big O: O(1)
+ */
+static int compare(const void *a, const void *b) {
+	return strcmp(*(char**)a, *(char**)b);
+}
+
+/* private helper: remove adjacent duplicates from the sorted array elts of n
+ * strings, freeing them, and return the number of strings left.
+ * Big O: O(n)
+ */
+static int dedup(char **elts, int n) {
+	int count = 0;
+	for (int i = 0; i < n; i++) {
+		if (count > 0 && strcmp(elts[i], elts[count-1]) == 0) {
+			free(elts[i]);
+		}
+		else {
+			elts[count++] = elts[i];
+		}
+	}
+	return count;
+}
@@ -0,0 +1,427 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 12/09/2025
+ *
+ * tiered.c
+ * Implementation of an ordered set of strings using a tiered vector. The
+ * sorted strings are split into blocks of B strings, a power of two about
+ * twice the square root of the capacity, and every block but the last is
+ * full. Passing a string through a block costs a cache miss while shifting
+ * within one is a memmove, so blocks are made larger than the square root.
+ * Each block is a circular array with its own starting offset, so a string
+ * can be pushed onto the front of a full block, dropping its last string,
+ * without moving the rest. An insertion shifts strings within one block and
+ * then passes a single string along through each later block, and a removal
+ * does the reverse. The blocks are stored one after another in one array,
+ * so there are no pointers to follow besides the strings themselves.
+ *
+ * Big O Time Complexities:
+ * createSet: O(sqrt n)
+ * buildSet: O(n log n)
+ * destroySet: O(n)
+ * numElements: O(1)
+ * addElement: O(sqrt n) amortized
+ * removeElement: O(sqrt n)
+ * toggleElement: O(sqrt n) amortized
+ * findElement: O(log n)
+ * getElements: O(n)
+ * firstElement: O(1)
+ * nextElement: O(1)
+ * rankElement: O(log n)
+ * selectElement: O(1)
+ * forEachInRange: O(log n + k) where k is the number of elements visited
+ * at: O(1)
+ * search: O(log n)
+ * grow: O(n)
+ * insertAt: O(sqrt n), O(n) when the set grows
+ * removeAt: O(sqrt n)
+ * dedup: O(n)
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "set.h"
+#include "order.h"
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#define RATIO 4	/* block size over number of blocks */
+
+typedef struct set {
+	size_t count;
+	int shift;		/* log2 of the block size */
+	size_t mask;		/* block size - 1 */
+	size_t blocks;		/* number of blocks allocated */
+	char **slots;		/* blocks * block size strings */
+	size_t *head;		/* slot of the first string of each block */
+	size_t cursor;
+} SET;
+
+static char **at(SET *sp, size_t i);
+static int search(SET *sp, char *elt, bool *found);
+static void grow(SET *sp);
+static void insertAt(SET *sp, size_t i, char *elt);
+static void removeAt(SET *sp, size_t i);
+static int compare(const void *a, const void *b);
+static int dedup(char **elts, int n);
+
+/* private helper: allocate an empty SET with a block size of the smallest
+ * power of two whose square is at least RATIO times maxElts, and enough
+ * blocks to hold maxElts strings.
+ * Big O: O(sqrt n)
+ */
+static SET *newSet(int maxElts) {
+	SET *sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	sp->count = 0;
+	sp->cursor = 0;
+	sp->shift = 1;
+	while ((1L << sp->shift) * (1L << sp->shift) < (long) RATIO * maxElts) {
+		sp->shift++;
+	}
+	sp->mask = (1L << sp->shift) - 1;
+	sp->blocks = (maxElts + sp->mask) >> sp->shift;
+	sp->head = calloc(sp->blocks, sizeof(size_t));
+	assert(sp->head != NULL);
+	return sp;
+}
+
+/* createSet: allocate and initialize a new SET sized for maxElts elements.
+ * It grows if more are added.
+ * Big O: O(sqrt n)
+ */
+SET *createSet(int maxElts) {
+	assert(maxElts > 0);
+	SET *sp = newSet(maxElts);
+	sp->slots = malloc(sizeof(char*) * (sp->blocks << sp->shift));
+	assert(sp->slots != NULL);
+	return sp;
+}
+
+/* buildSet: return a new SET holding the distinct strings of elts, an
+ * unsorted array of n strings, sized for maxElts elements or for all of them
+ * if that is more. Sorted strings already are a tiered vector whose blocks
+ * all start at offset 0, so the sorted array is adopted as the set's own,
+ * which means it and its strings must have been allocated with malloc.
+ * Duplicates are freed.
+ * Big O: O(n log n)
+ */
+SET *buildSet(char **elts, int n, int maxElts) {
+	assert((elts != NULL) && (n >= 0) && (maxElts > 0));
+	qsort(elts, n, sizeof(char*), compare);
+	n = dedup(elts, n);
+	SET *sp = newSet(n > maxElts ? n : maxElts);
+	sp->count = n;
+	sp->slots = realloc(elts, sizeof(char*) * (sp->blocks << sp->shift));
+	assert(sp->slots != NULL);
+	return sp;
+}
+
+/* destroySet: free all strings owned by the set, the blocks, and the set
+ * structure.
+ * Big O: O(n)
+ */
+void destroySet(SET *sp) {
+	assert(sp != NULL);
+	for (size_t i = 0; i < sp->count; i++) {
+		free(*at(sp, i));
+	}
+	free(sp->slots);
+	free(sp->head);
+	free(sp);
+}
+
+/* numElements: return the number of elements stored
+ * Big O: O(1)
+ */
+int numElements(SET *sp) {
+	assert(sp != NULL);
+	return sp->count;
+}
+
+/* addElement: insert a copy of elt in the set if it is not present.
+ * Big O: O(sqrt n) amortized
+ */
+void addElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int idx = search(sp, elt, &found);
+	if (!found) {
+		char *newElt = strdup(elt);
+		assert(newElt != NULL);
+		insertAt(sp, idx, newElt);
+	}
+}
+
+/* removeElement: remove elt if present.
+ * Big O: O(sqrt n)
+ */
+void removeElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int idx = search(sp, elt, &found);
+	if (found) {
+		free(*at(sp, idx));
+		removeAt(sp, idx);
+	}
+}
+
+/* toggleElement: insert a copy of elt if it is not present, or remove it if
+ * it is, with a single binary search. Returns true if elt was inserted.
+ * Big O: O(sqrt n) amortized
+ */
+bool toggleElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int idx = search(sp, elt, &found);
+	if (found) {
+		free(*at(sp, idx));
+		removeAt(sp, idx);
+		return false;
+	}
+	char *newElt = strdup(elt);
+	assert(newElt != NULL);
+	insertAt(sp, idx, newElt);
+	return true;
+}
+
+/* findElement: return pointer to stored string equal to elt, or NULL if not
+ * found.
+ * Big O: O(log n)
+ */
+char *findElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int idx = search(sp, elt, &found);
+	return found ? *at(sp, idx) : NULL;
+}
+
+/* getElements: return a newly-allocated array of pointers to the elements
+ * stored in the set, in sorted order.
+ * Big O: O(n)
+ */
+char **getElements(SET *sp) {
+	assert(sp != NULL);
+	char **cpy = malloc(sizeof(char*) * sp->count);
+	assert(cpy != NULL);
+	for (size_t i = 0; i < sp->count; i++) {
+		cpy[i] = *at(sp, i);
+	}
+	return cpy;
+}
+
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The elements are
+ * visited in place in sorted order, without allocating. The set must not be
+ * changed until nextElement returns NULL.
+ * Big O: O(1)
+ */
+char *firstElement(SET *sp) {
+	assert(sp != NULL);
+	sp->cursor = 0;
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned.
+ * Big O: O(1)
+ */
+char *nextElement(SET *sp) {
+	assert(sp != NULL);
+	if (sp->cursor < sp->count) {
+		return *at(sp, sp->cursor++);
+	}
+	return NULL;
+}
+
+/* rankElement: return the number of elements in the set less than elt,
+ * which is the position of elt in sorted order if it is present.
+ * Big O: O(log n)
+ */
+int rankElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	return search(sp, elt, &found);
+}
+
+/* selectElement: return the element at position k in sorted order, counting
+ * from 0, or NULL if k is out of range.
+ * Big O: O(1)
+ */
+char *selectElement(SET *sp, int k) {
+	assert(sp != NULL);
+	if (k < 0 || k >= sp->count) {
+		return NULL;
+	}
+	return *at(sp, k);
+}
+
+/* forEachInRange: call visit(elt, arg) on each element from lo to hi
+ * inclusive, in sorted order, where a NULL bound is unlimited, and return
+ * the number of elements visited. The start is found by binary search.
+ * Big O: O(log n + k) where k is the number of elements visited
+ */
+int forEachInRange(SET *sp, char *lo, char *hi, void (*visit)(), void *arg) {
+	assert((sp != NULL) && (visit != NULL));
+	bool found;
+	size_t i = lo != NULL ? search(sp, lo, &found) : 0;
+	int visited = 0;
+	for (; i < sp->count && (hi == NULL || strcmp(*at(sp, i), hi) <= 0); i++) {
+		(*visit)(*at(sp, i), arg);
+		visited++;
+	}
+	return visited;
+}
+
+/* private helper: return the slot holding the string at position i in
+ * sorted order, which is in block i / B at its offset plus i % B, wrapping
+ * around the block.
+ * Big O: O(1)
+ */
+static char **at(SET *sp, size_t i) {
+	size_t b = i >> sp->shift;
+	return &sp->slots[(b << sp->shift) + ((sp->head[b] + i) & sp->mask)];
+}
+
+/* private helper: returns the index of element in set or the index where you
+ * would insert it, found using binary search.
+ * Big O: O(log n)
+ */
+static int search(SET *sp, char *elt, bool *found) {
+	int lo = 0, hi = sp->count - 1, mid, diff;
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+		diff = strcmp(elt, *at(sp, mid));
+		if (diff > 0) {
+			lo = mid + 1;
+		}
+		else if (diff < 0) {
+			hi = mid - 1;
+		}
+		else {
+			*found = true;
+			return mid;
+		}
+	}
+	*found = false;
+	return lo;
+}
+
+/* private helper: double the capacity, keeping the block size near the
+ * square root of it. While the block size is more than RATIO times the
+ * number of blocks, the number of blocks is doubled and the old blocks stay
+ * as they are.
+ * Otherwise the block size is doubled instead, and the strings are copied
+ * into new blocks in order, all starting at offset 0.
+ * Big O: O(n)
+ */
+static void grow(SET *sp) {
+	if (sp->blocks * RATIO < sp->mask + 1) {
+		sp->slots = realloc(sp->slots, sizeof(char*) * (sp->blocks << (sp->shift + 1)));
+		sp->head = realloc(sp->head, sizeof(size_t) * sp->blocks * 2);
+		assert((sp->slots != NULL) && (sp->head != NULL));
+		memset(sp->head + sp->blocks, 0, sizeof(size_t) * sp->blocks);
+		sp->blocks *= 2;
+		return;
+	}
+	char **slots = malloc(sizeof(char*) * (sp->blocks << (sp->shift + 1)));
+	assert(slots != NULL);
+	for (size_t i = 0; i < sp->count; i++) {
+		slots[i] = *at(sp, i);
+	}
+	free(sp->slots);
+	sp->slots = slots;
+	sp->shift++;
+	sp->mask = (1L << sp->shift) - 1;
+	memset(sp->head, 0, sizeof(size_t) * sp->blocks);
+}
+
+/* private helper: insert elt at position i. The strings after it in its block
+ * are shifted up one place with at most two memmoves, one on each side of
+ * where the block wraps around, the last one falling off the end, and it is
+ * pushed onto the front of the next block by moving that block's offset
+ * back one slot, into the slot of its own last string. That one is passed
+ * along in the same way until the last block, which has room for it.
+ * Big O: O(sqrt n)
+ */
+static void insertAt(SET *sp, size_t i, char *elt) {
+	if (sp->count == sp->blocks << sp->shift) {
+		grow(sp);
+	}
+	size_t b = i >> sp->shift, last = sp->count >> sp->shift;
+	size_t end = b == last ? sp->count + 1 : (b + 1) << sp->shift;
+	char **base = &sp->slots[b << sp->shift];
+	size_t first = (sp->head[b] + i) & sp->mask, top = (sp->head[b] + end - 1) & sp->mask;
+	char *carry = base[top];
+	if (first <= top) {
+		memmove(base + first + 1, base + first, sizeof(char*) * (top - first));
+	}
+	else {
+		memmove(base + 1, base, sizeof(char*) * top);
+		base[0] = base[sp->mask];
+		memmove(base + first + 1, base + first, sizeof(char*) * (sp->mask - first));
+	}
+	base[first] = elt;
+	for (b++; b <= last; b++) {
+		sp->head[b] = (sp->head[b] - 1) & sp->mask;
+		char **slot = &sp->slots[(b << sp->shift) + sp->head[b]];
+		char *next = *slot;
+		*slot = carry;
+		carry = next;
+	}
+	sp->count++;
+}
+
+/* private helper: remove the string at position i. The strings after it in
+ * its block are shifted down one place, and the first string of the next
+ * block fills the last place, leaving that block's first slot free to
+ * become its last by moving its offset forward. That is repeated through
+ * the last block, which ends up one string shorter.
+ * Big O: O(sqrt n)
+ */
+static void removeAt(SET *sp, size_t i) {
+	size_t b = i >> sp->shift, last = (sp->count - 1) >> sp->shift;
+	size_t end = b == last ? sp->count : (b + 1) << sp->shift;
+	char **base = &sp->slots[b << sp->shift];
+	size_t first = (sp->head[b] + i) & sp->mask, top = (sp->head[b] + end - 1) & sp->mask;
+	if (first <= top) {
+		memmove(base + first, base + first + 1, sizeof(char*) * (top - first));
+	}
+	else {
+		memmove(base + first, base + first + 1, sizeof(char*) * (sp->mask - first));
+		base[sp->mask] = base[0];
+		memmove(base, base + 1, sizeof(char*) * top);
+	}
+	for (b++; b <= last; b++) {
+		char *front = sp->slots[(b << sp->shift) + sp->head[b]];
+		sp->head[b] = (sp->head[b] + 1) & sp->mask;
+		*at(sp, (b << sp->shift) - 1) = front;
+	}
+	sp->count--;
+}
+
+/* private helper: compare the strings pointed to by a and b, for qsort.
+ * Big O: O(1)
+ */
+static int compare(const void *a, const void *b) {
+	return strcmp(*(char**)a, *(char**)b);
+}
+
+/* private helper: remove adjacent duplicates from the sorted array elts of n
+ * strings, freeing them, and return the number of strings left.
+ * Big O: O(n)
+ */
+static int dedup(char **elts, int n) {
+	int count = 0;
+	for (int i = 0; i < n; i++) {
+		if (count > 0 && strcmp(elts[i], elts[count - 1]) == 0) {
+			free(elts[i]);
+		}
+		else {
+			elts[count++] = elts[i];
+		}
+	}
+	return count;
+}
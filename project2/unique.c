@@ -35,7 +35,7 @@
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ], **elts;
+    char buffer[BUFSIZ], *word;
     SET *unique;
     int i, words;
     bool lflag = false;
@@ -103,14 +103,9 @@ int main(int argc, char *argv[])
 
     /* Print the list of words if desired. */
 
-    if (lflag) {
-	elts = getElements(unique);
-
-	for (i = 0; i < numElements(unique); i ++)
-	    printf("%s\n", elts[i]);
-
-	free(elts);
-    }
+    if (lflag)
+	for (word = firstElement(unique); word != NULL; word = nextElement(unique))
+	    printf("%s\n", word);
 
     destroySet(unique);
     exit(EXIT_SUCCESS);
@@ -12,8 +12,11 @@
  * numElements: O(1)
  * addElement: O(n) 
  * removeElement: O(n)
+ * toggleElement: O(n)
  * findElement: O(n)
  * getElements: O(n)
+ * firstElement: O(1)
+ * nextElement: O(1)
  * search: O(n)
  */
 
@@ -27,6 +30,7 @@ typedef struct set {
 	size_t count;
 	size_t length;
 	char **data;
+	size_t cursor;
 } SET;
 
 /* private helper: linear search for elt; returns index or -1 if not found
@@ -45,6 +49,7 @@ SET *createSet(int maxElts) {
 	assert(maxElts > 0);
 	sp->count = 0;
 	sp->length = maxElts;
+	sp->cursor = 0;
 	sp->data = malloc(sizeof(char*) * maxElts);
 	assert(sp->data != NULL);
 	return sp;
@@ -99,6 +104,27 @@ void removeElement(SET *sp, char *elt) {
 	}
 }
 
+/* toggleElement: insert a copy of elt if it is not present, or remove it if
+ * it is, with a single linear search. Returns true if elt was inserted.
+ * Big O: O(n) for linear search; insertion or removal is O(1).
+ */
+bool toggleElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	int idx = search(sp, elt);
+	if (idx != -1) {
+		free(sp->data[idx]);
+		sp->data[idx] = sp->data[sp->count-1];
+		sp->count--;
+		return false;
+	}
+	assert(sp->count < sp->length);
+	char* newElt = strdup(elt);
+	assert(newElt != NULL);
+	sp->data[sp->count] = newElt;
+	sp->count++;
+	return true;
+}
+
 /* findElement: return pointer to stored string equal to elt, or NULL if not
  * found.
  * Big O: O(n)
@@ -124,6 +150,30 @@ char **getElements(SET *sp) {
 	return cpy;
 }
 
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The elements are
+ * visited in place, without allocating. The set must not be changed
+ * until nextElement returns NULL.
+ * Big O: O(1)
+ */
+char *firstElement(SET *sp) {
+	assert(sp != NULL);
+	sp->cursor = 0;
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned.
+ * Big O: O(1)
+ */
+char *nextElement(SET *sp) {
+	assert(sp != NULL);
+	if (sp->cursor < sp->count) {
+		return sp->data[sp->cursor++];
+	}
+	return NULL;
+}
+
 static int search(SET *sp, char *elt) {
 	assert(sp != NULL);
 	for (int i = 0; i < sp->count; i++) {
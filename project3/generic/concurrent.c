@@ -0,0 +1,556 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 10/19/2025
+ *
+ * concurrent.c
+ * Implementation of a generic hash table that many threads may use at
+ * once, using open addressing with linear probing on an array of atomic
+ * slot pointers. A slot is Empty (NULL), holds an element, or is a
+ * Tombstone left by a removal. All changes are made with compare-and-swap.
+ * findElement never waits for another thread; updates may have to wait
+ * for a migration to finish, so the set as a whole is not lock-free.
+ *
+ * Insertion: a thread inserting elt first claims the first Tombstone on
+ * its probe sequence, or the Empty slot ending it, by storing elt with its
+ * second lowest bit set (Pending). It then probes again. If it finds an
+ * equal element, or a Pending slot earlier in the sequence, it gives the
+ * slot back as a Tombstone and starts over. A Pending slot later in the
+ * sequence is turned into a Tombstone, so that its owner starts over and
+ * finds elt instead of the thread waiting for it. Otherwise no other thread
+ * can be inserting an equal element, and the Pending bit is cleared.
+ * Readers skip Pending slots.
+ *
+ * Growth: once three quarters of a table's slots are used, a larger table
+ * is linked to it as next, and every updating thread that notices helps
+ * move elements across, claiming CHUNK slots at a time. Each old slot is
+ * frozen first (Empty, Tombstone, and Pending slots become Moved, elements
+ * get their low bit set), so no update can land in it afterwards. Updates
+ * on the new table start only after every slot has been copied; until
+ * then, updating threads help or wait. A reader never helps. Until the
+ * copy is complete it searches the old table, where every element the
+ * table held stays frozen, and afterwards the new one. Old tables are kept
+ * until destroySet so a slow reader can still finish its probe.
+ *
+ * Elements must be at least 4-byte aligned, as malloc'd pointers are,
+ * because the two low bits of a stored pointer are used as the Frozen and
+ * Pending tags. Keys that are only searched for need not be.
+ * upsertElement and toggleElement store elt itself, so the caller must
+ * already own it, and the slot they return must not be written: any
+ * thread may start moving it to a larger table at any time.
+ *
+ * Big O Time Complexities:
+ * createSet: O(m) - where m is maxElts
+ * destroySet: O(t) - where t is the number of tables ever allocated
+ * numElements: O(1)
+ * addElement: O(1) amortized average, O(m) worst case
+ * upsertElement: O(1) amortized average, O(m) worst case
+ * toggleElement: O(1) amortized average, O(m) worst case
+ * removeElement: O(1) average, O(m) worst case
+ * findElement: O(1) average, O(m) worst case
+ * findElements: O(n) average, O(nm) worst case - where n is the batch size
+ * getElements: O(m)
+ * firstElement: O(m) worst case
+ * nextElement: O(m) worst case, O(m) for a whole iteration
+ * help: O(m) shared among the helping threads
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "set.h"
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sched.h>
+
+#define CHUNK 256	/* old slots claimed at a time while migrating */
+#define BATCH 16	/* keys hashed and prefetched together by findElements */
+
+static long marks[2];	/* aligned, so never mistaken for tagged elements */
+#define TOMBSTONE ((void *) &marks[0])
+#define MOVED ((void *) &marks[1])
+
+#define FROZEN(p) (((uintptr_t) (p)) & 1)
+#define PENDING(p) (((uintptr_t) (p)) & 2)
+#define FREEZE(p) ((void *) (((uintptr_t) (p)) | 1))
+#define CLAIM(p) ((void *) (((uintptr_t) (p)) | 2))
+#define THAW(p) ((void *) (((uintptr_t) (p)) & ~(uintptr_t) 1))
+
+struct table {
+	size_t length;
+	_Atomic(void *) *slots;
+	atomic_size_t used;		/* slots no longer Empty */
+	atomic_size_t claimed;		/* slots claimed for migration */
+	atomic_size_t copied;		/* slots done migrating */
+	_Atomic(struct table *) next;	/* table being migrated into */
+	struct table *older;		/* previously allocated table */
+};
+
+typedef struct set {
+	atomic_int count;
+	_Atomic(struct table *) cur;
+	_Atomic(struct table *) tables;	/* every table, newest first */
+	struct table *iter;		/* table being iterated */
+	size_t cursor;			/* next slot of iter to visit */
+	int (*compare)();
+	unsigned (*hash)();
+} SET;
+
+/* private helper: allocate a table of length Empty slots and record it in
+ * the list of tables freed by destroySet.
+ * Big O: O(m)
+ */
+static struct table *newTable(SET *sp, size_t length) {
+	struct table *tp = malloc(sizeof(struct table));
+	assert(tp != NULL);
+	tp->length = length;
+	tp->slots = malloc(sizeof(_Atomic(void *)) * length);
+	assert(tp->slots != NULL);
+	for (size_t i = 0; i < length; i++) {
+		atomic_init(&tp->slots[i], NULL);
+	}
+	atomic_init(&tp->used, 0);
+	atomic_init(&tp->claimed, 0);
+	atomic_init(&tp->copied, 0);
+	atomic_init(&tp->next, NULL);
+	return tp;
+}
+
+/* private helper: add tp to the list of tables owned by the set.
+ * Big O: O(1) without contention
+ */
+static void retain(SET *sp, struct table *tp) {
+	tp->older = atomic_load(&sp->tables);
+	while (!atomic_compare_exchange_weak(&sp->tables, &tp->older, tp))
+		;
+}
+
+/* private helper: copy elt, which was frozen in the old table, into the
+ * first Empty slot of its probe sequence in tp.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static void place(SET *sp, struct table *tp, void *elt) {
+	size_t locn = (*sp->hash)(elt) % tp->length;
+	void *expected;
+	for (;;) {
+		expected = NULL;
+		if (atomic_compare_exchange_strong(&tp->slots[locn], &expected, elt)) {
+			atomic_fetch_add(&tp->used, 1);
+			return;
+		}
+		locn = (locn + 1) % tp->length;
+	}
+}
+
+/* private helper: link a new table to tp unless another thread already
+ * has. The new table doubles in size unless most used slots are
+ * Tombstones, in which case the same size is enough.
+ * Big O: O(m)
+ */
+static void startResize(SET *sp, struct table *tp) {
+	struct table *next, *expected = NULL;
+	size_t length = tp->length;
+	if (atomic_load(&tp->next) != NULL) {
+		return;
+	}
+	if ((size_t) atomic_load(&sp->count) * 4 >= length) {
+		length *= 2;
+	}
+	next = newTable(sp, length);
+	if (atomic_compare_exchange_strong(&tp->next, &expected, next)) {
+		retain(sp, next);
+	}
+	else {
+		free(next->slots);
+		free(next);
+	}
+}
+
+/* private helper: help move the elements of tp into tp->next, CHUNK slots
+ * at a time, then wait for other helpers to finish and make the new table
+ * current. Returns the new table. Only updates call it.
+ * Big O: O(m) shared among the helping threads
+ */
+static struct table *help(SET *sp, struct table *tp) {
+	struct table *next = atomic_load(&tp->next);
+	struct table *expected = tp;
+	size_t start, end, i;
+	void *v;
+
+	while ((start = atomic_fetch_add(&tp->claimed, CHUNK)) < tp->length) {
+		end = start + CHUNK < tp->length ? start + CHUNK : tp->length;
+		for (i = start; i < end; i++) {
+			v = atomic_load(&tp->slots[i]);
+			for (;;) {
+				if (v == NULL || v == TOMBSTONE || PENDING(v)) {
+					if (atomic_compare_exchange_weak(&tp->slots[i], &v, MOVED)) {
+						break;
+					}
+				}
+				else if (atomic_compare_exchange_weak(&tp->slots[i], &v, FREEZE(v))) {
+					place(sp, next, v);
+					break;
+				}
+			}
+		}
+		atomic_fetch_add(&tp->copied, end - start);
+	}
+	while (atomic_load(&tp->copied) < tp->length) {
+		sched_yield();
+	}
+	atomic_compare_exchange_strong(&sp->cur, &expected, next);
+	return next;
+}
+
+/* private helper: return the current table, first finishing any
+ * migration that is under way.
+ * Big O: O(1), or O(m) shared when helping a migration
+ */
+static struct table *current(SET *sp) {
+	struct table *tp = atomic_load(&sp->cur);
+	while (atomic_load(&tp->next) != NULL) {
+		tp = help(sp, tp);
+	}
+	return tp;
+}
+
+/* private helper: search for elt starting at the table tp. Returns the
+ * slot holding an equal element, which is stored in *value, or NULL if
+ * there is none. An Empty slot ends the search even during a migration,
+ * as the element was not in the set when the slot was read. Once every
+ * slot of tp has been copied the search goes on in the next table. Until
+ * then, Moved slots are skipped, since they may have been Tombstones, and
+ * a frozen match is returned thawed: it cannot have been removed yet, as
+ * removing it needs the copy to be complete. Its slot can no longer be
+ * changed, so a removal will find it again in the next table.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static _Atomic(void *) *lookup(SET *sp, struct table *tp, void *elt, unsigned hash, void **value) {
+	size_t locn, i;
+	void *v;
+	for (;;) {
+		locn = hash % tp->length;
+		for (i = 0; i < tp->length; i++) {
+			v = atomic_load(&tp->slots[locn]);
+			if (v == NULL) {
+				return NULL;
+			}
+			if (v == MOVED || FROZEN(v)) {
+				if (atomic_load(&tp->copied) == tp->length) {
+					break;
+				}
+				if (v != MOVED && (*sp->compare)(THAW(v), elt) == 0) {
+					*value = THAW(v);
+					return &tp->slots[locn];
+				}
+			}
+			else if (v != TOMBSTONE && !PENDING(v) && (*sp->compare)(v, elt) == 0) {
+				*value = v;
+				return &tp->slots[locn];
+			}
+			locn = (locn + 1) % tp->length;
+		}
+		if ((tp = atomic_load(&tp->next)) == NULL) {
+			return NULL;
+		}
+	}
+}
+
+/* private helper: the shared body of upsertElement and toggleElement. If
+ * an element equal to elt is present, either its slot is returned with
+ * *found set to true, or, when toggling, it is replaced by a Tombstone,
+ * stored in *removed, and NULL is returned. Otherwise elt itself is
+ * inserted using the Pending protocol described above and its slot
+ * returned.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+static void **update(SET *sp, void *elt, bool *found, void **removed) {
+	unsigned hash = (*sp->hash)(elt);
+	_Atomic(void *) *slot, *mine;
+	struct table *tp;
+	size_t home, end, target, i;
+	void *v;
+
+retry:
+	tp = current(sp);
+	home = hash % tp->length;
+	target = tp->length;
+	for (i = 0; i < tp->length; i++) {
+		slot = &tp->slots[(home + i) % tp->length];
+		v = atomic_load(slot);
+		if (v == NULL) {
+			break;
+		}
+		if (v == MOVED || FROZEN(v)) {
+			goto retry;
+		}
+		if (v == TOMBSTONE) {
+			if (target == tp->length) {
+				target = i;
+			}
+		}
+		else if (!PENDING(v) && (*sp->compare)(v, elt) == 0) {
+			if (removed == NULL) {
+				*found = true;
+				return (void **) slot;
+			}
+			if (!atomic_compare_exchange_strong(slot, &v, TOMBSTONE)) {
+				goto retry;
+			}
+			atomic_fetch_sub(&sp->count, 1);
+			*found = true;
+			*removed = v;
+			return NULL;
+		}
+	}
+
+	end = i;
+	if (target == tp->length) {
+		if (end == tp->length || (atomic_load(&tp->used) + 1) * 4 > tp->length * 3) {
+			startResize(sp, tp);
+			goto retry;
+		}
+		target = end;
+	}
+	assert(((uintptr_t) elt & 3) == 0);	/* the low bits are tags */
+	mine = &tp->slots[(home + target) % tp->length];
+	v = target == end ? NULL : TOMBSTONE;
+	if (!atomic_compare_exchange_strong(mine, &v, CLAIM(elt))) {
+		goto retry;
+	}
+	if (target == end) {
+		atomic_fetch_add(&tp->used, 1);
+	}
+
+	for (i = 0; i < tp->length; i++) {
+		if (i == target) {
+			continue;
+		}
+		slot = &tp->slots[(home + i) % tp->length];
+		v = atomic_load(slot);
+		if (i > target) {
+			while (PENDING(v) && !atomic_compare_exchange_weak(slot, &v, TOMBSTONE))
+				;
+			if (PENDING(v)) {
+				v = TOMBSTONE;
+			}
+		}
+		if (v == NULL) {
+			break;
+		}
+		if (v == MOVED || FROZEN(v) || PENDING(v) ||
+			(v != TOMBSTONE && (*sp->compare)(v, elt) == 0)) {
+			v = CLAIM(elt);
+			atomic_compare_exchange_strong(mine, &v, TOMBSTONE);
+			goto retry;
+		}
+	}
+
+	v = CLAIM(elt);
+	if (!atomic_compare_exchange_strong(mine, &v, elt)) {
+		goto retry;
+	}
+	atomic_fetch_add(&sp->count, 1);
+	*found = false;
+	return (void **) mine;
+}
+
+/* createSet: allocate and initialize a new concurrent SET with an initial
+ * capacity of maxElts elements. Stores function pointers for comparison
+ * and hashing, which must be safe to call from several threads.
+ * Big O: O(m)
+ */
+SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()) {
+	SET *sp;
+	struct table *tp;
+	assert(maxElts > 0);
+	assert(compare != NULL && hash != NULL);
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	sp->compare = compare;
+	sp->hash = hash;
+	atomic_init(&sp->count, 0);
+	atomic_init(&sp->tables, NULL);
+	tp = newTable(sp, maxElts);
+	retain(sp, tp);
+	atomic_init(&sp->cur, tp);
+	sp->iter = tp;
+	sp->cursor = 0;
+	return sp;
+}
+
+/* destroySet: free every table the set has used, and the set structure.
+ * Does NOT free individual elements as the caller retains ownership of the
+ * data. No other thread may be using the set.
+ * Big O: O(t) - where t is the number of tables ever allocated
+ */
+void destroySet(SET *sp) {
+	struct table *tp, *older;
+	assert(sp != NULL);
+	for (tp = atomic_load(&sp->tables); tp != NULL; tp = older) {
+		older = tp->older;
+		free(tp->slots);
+		free(tp);
+	}
+	free(sp);
+}
+
+/* numElements: return the number of elements stored
+ * Big O: O(1)
+ */
+int numElements(SET *sp) {
+	assert(sp != NULL);
+	return atomic_load(&sp->count);
+}
+
+/* addElement: insert elt if no equal element is present. Stores the
+ * pointer directly without copying.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void addElement(SET *sp, void *elt) {
+	bool found;
+	assert((sp != NULL) && (elt != NULL));
+	update(sp, elt, &found, NULL);
+}
+
+/* upsertElement: find or insert elt with a single hash and probe. If an
+ * equal element is present, *found is set to true and the address of its
+ * slot is returned. Otherwise elt itself is inserted, *found is set to
+ * false, and the address of the new slot is returned. Unlike the other
+ * sets, the slot must not be written, so elt must already be owned by the
+ * caller; a caller that inserts a copy frees it when *found is true.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void **upsertElement(SET *sp, void *elt, bool *found) {
+	assert((sp != NULL) && (elt != NULL) && (found != NULL));
+	return update(sp, elt, found, NULL);
+}
+
+/* toggleElement: insert elt if no equal element is present, or remove the
+ * equal element if there is one, using a single hash and probe. On removal
+ * the removed element is stored in *removed and NULL is returned. On
+ * insertion the address of the new slot is returned, and as with
+ * upsertElement it must not be written.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void **toggleElement(SET *sp, void *elt, void **removed) {
+	bool found;
+	assert((sp != NULL) && (elt != NULL) && (removed != NULL));
+	return update(sp, elt, &found, removed);
+}
+
+/* removeElement: remove elt from the set if present by replacing it with
+ * a Tombstone. Does NOT free the element as caller owns the data.
+ * Big O: O(1) average case, O(m) worst case
+ */
+void removeElement(SET *sp, void *elt) {
+	_Atomic(void *) *slot;
+	void *v;
+	assert((sp != NULL) && (elt != NULL));
+	unsigned hash = (*sp->hash)(elt);
+	while ((slot = lookup(sp, current(sp), elt, hash, &v)) != NULL) {
+		if (atomic_compare_exchange_strong(slot, &v, TOMBSTONE)) {
+			atomic_fetch_sub(&sp->count, 1);
+			return;
+		}
+	}
+}
+
+/* findElement: return the stored element equal to elt, or NULL if not
+ * found. Never waits for other threads, even during a migration.
+ * Big O: O(1) average case, O(m) worst case
+ */
+void *findElement(SET *sp, void *elt) {
+	void *v;
+	assert((sp != NULL) && (elt != NULL));
+	if (lookup(sp, atomic_load(&sp->cur), elt, (*sp->hash)(elt), &v) == NULL) {
+		return NULL;
+	}
+	return v;
+}
+
+/* findElements: look up the n elements of elts and store the match for
+ * each (or NULL) in the same position of matches. Keys are handled BATCH
+ * at a time, hashing all of them and prefetching their home slots before
+ * probing.
+ * Big O: O(n) average case, O(nm) worst case - where n is the batch size
+ */
+void findElements(SET *sp, void **elts, int n, void **matches) {
+	assert((sp != NULL) && (elts != NULL) && (matches != NULL));
+	unsigned hashes[BATCH];
+	struct table *tp;
+	int i, j, m;
+	void *v;
+	for (i = 0; i < n; i += BATCH) {
+		m = n - i < BATCH ? n - i : BATCH;
+		tp = atomic_load(&sp->cur);
+		for (j = 0; j < m; j++) {
+			assert(elts[i + j] != NULL);
+			hashes[j] = (*sp->hash)(elts[i + j]);
+			__builtin_prefetch(&tp->slots[hashes[j] % tp->length]);
+		}
+		for (j = 0; j < m; j++) {
+			if (lookup(sp, tp, elts[i + j], hashes[j], &v) == NULL) {
+				v = NULL;
+			}
+			matches[i + j] = v;
+		}
+	}
+}
+
+/* getElements: return a newly-allocated array of generic pointers to the
+ * elements stored in the set. Elements added or removed by other threads
+ * while it runs may or may not be included; at most numElements elements
+ * at the time of the call are returned.
+ * Big O: O(m)
+ */
+void *getElements(SET *sp) {
+	assert(sp != NULL);
+	struct table *tp = current(sp);
+	int count = atomic_load(&sp->count);
+	void **cpy;
+	void *v;
+	cpy = malloc((count > 0 ? count : 1) * sizeof(void *));
+	assert(cpy != NULL);
+	int j = 0;
+	for (size_t i = 0; i < tp->length && j < count; i++) {
+		v = atomic_load(&tp->slots[i]);
+		if (v != NULL && v != TOMBSTONE && v != MOVED && !PENDING(v)) {
+			cpy[j] = THAW(v);
+			j++;
+		}
+	}
+	return cpy;
+}
+
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The elements are
+ * visited in place in the current table without allocating. As with
+ * getElements, elements added or removed by other threads meanwhile may or
+ * may not be returned, and only one thread may iterate at a time.
+ * Big O: O(m) worst case
+ */
+void *firstElement(SET *sp) {
+	assert(sp != NULL);
+	sp->iter = current(sp);
+	sp->cursor = 0;
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every slot has been visited.
+ * Big O: O(m) worst case, O(m) for a whole iteration
+ */
+void *nextElement(SET *sp) {
+	void *v;
+	assert(sp != NULL);
+	while (sp->cursor < sp->iter->length) {
+		v = atomic_load(&sp->iter->slots[sp->cursor++]);
+		if (v != NULL && v != TOMBSTONE && v != MOVED && !PENDING(v)) {
+			return THAW(v);
+		}
+	}
+	return NULL;
+}
@@ -3,29 +3,39 @@
  *
  * Copyright:	2021, Darren C. Atkinson
  *
- * Description: This file contains the main function for testing a set
+ * Description: This file contains the main function for testing a map
  *              abstract data type for strings.
  *
  *              The program takes one file as a command line argument and
  *              counts the number of times each word appears in the file.
+ *
+ *              With -j N the file is read into memory and split into N
+ *              chunks at whitespace, each counted by its own thread.  A
+ *              thread keeps one private map per shard, choosing the shard
+ *              from the hash of the word, so no locking is needed.  Then
+ *              each shard is merged by its own thread and printed.
  */
 
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
-# include <assert.h>
-# include "set.h"
-
-struct entry {
-    char *word;
-    int count;
-};
+# include <ctype.h>
+# include <pthread.h>
+# include "map.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
 
 # define MAX_SIZE 18000
 
+# define MAX_THREADS 256
+
+
+static int nthreads;
+static char *text;
+static size_t *bounds;
+static MAP ***shards;
+
 
 /*
  * Function:    strhash
@@ -46,26 +56,218 @@ static unsigned strhash(char *s)
 
 
 /*
- * Function:	hashEntry
+ * Function:	copyWord
+ *
+ * Description:	Return a copy of a word S to be kept as a key.
+ */
+
+static void *copyWord(char *s)
+{
+    return strdup(s);
+}
+
+
+/*
+ * Function:	printEntry
+ *
+ * Description:	Print a word and its count, then deallocate the word.
+ */
+
+static void printEntry(char *word, int count, void *arg)
+{
+    printf("%s: %d\n", word, count);
+    free(word);
+}
+
+
+/*
+ * Function:	printWord
+ *
+ * Description:	Print a word and its count.  The word is part of the text
+ *		read into memory and is not deallocated.
+ */
+
+static void printWord(char *word, int count, void *arg)
+{
+    printf("%s: %d\n", word, count);
+}
+
+
+/*
+ * Function:	mergeEntry
+ *
+ * Description:	Add the count of a word to the map INTO.
+ */
+
+static void mergeEntry(char *word, int count, MAP *into)
+{
+    (*upsert(into, word, NULL)) += count;
+}
+
+
+/*
+ * Function:	shardOf
+ *
+ * Description:	Return the shard for a word with hash value HASH, taken
+ *		from the high bits of the mixed hash value.
+ */
+
+static int shardOf(unsigned hash)
+{
+    return ((unsigned long long) (hash * 2654435761u) * nthreads) >> 32;
+}
+
+
+/*
+ * Function:	countChunk
+ *
+ * Description:	Thread function that counts the words in chunk I of the
+ *		text into the thread's own shard maps.  Each word is ended
+ *		in place, since the chunk ends just after a whitespace
+ *		character or at the end of the text.
+ */
+
+static void *countChunk(void *arg)
+{
+    long i = (long) arg;
+    char *p, *end, *word;
+    MAP **maps;
+    int s;
+
+
+    maps = malloc(sizeof(MAP *) * nthreads);
+
+    for (s = 0; s < nthreads; s ++)
+	maps[s] = createMap(MAX_SIZE / nthreads + 1, strcmp, strhash);
+
+    p = text + bounds[i];
+    end = text + bounds[i + 1];
+
+    while (p < end) {
+	while (p < end && isspace((unsigned char) *p))
+	    p ++;
+
+	if (p == end)
+	    break;
+
+	word = p;
+
+	while (p < end && !isspace((unsigned char) *p))
+	    p ++;
+
+	*p ++ = '\0';
+	(*upsert(maps[shardOf(strhash(word))], word, NULL)) ++;
+    }
+
+    shards[i] = maps;
+    return NULL;
+}
+
+
+/*
+ * Function:	mergeShard
  *
- * Description:	Return a hash value for an entry based on its word.
+ * Description:	Thread function that merges shard S of every thread into
+ *		the maps of the first thread.
  */
 
-static unsigned hashEntry(struct entry *ep)
+static void *mergeShard(void *arg)
 {
-    return strhash(ep->word);
+    long s = (long) arg;
+    int i;
+
+
+    for (i = 1; i < nthreads; i ++) {
+	forEachEntry(shards[i][s], mergeEntry, shards[0][s]);
+	destroyMap(shards[i][s]);
+    }
+
+    return NULL;
 }
 
 
 /*
- * Function:	compareEntries
+ * Function:	readText
  *
- * Description:	Compare two entries as in strcmp().
+ * Description:	Read the open file FP into memory, ending it with a null
+ *		character, and split it into chunks for the threads.  A
+ *		chunk boundary is moved just past the next whitespace
+ *		character so that no word is split.
  */
 
-static int compareEntries(struct entry *ep1, struct entry *ep2)
+static void readText(FILE *fp)
 {
-    return strcmp(ep1->word, ep2->word);
+    size_t size, length, b;
+    int i;
+
+
+    size = BUFSIZ;
+    length = 0;
+    text = malloc(size + 1);
+
+    while ((b = fread(text + length, 1, size - length, fp)) > 0)
+	if ((length += b) == size)
+	    text = realloc(text, (size *= 2) + 1);
+
+    text[length] = '\0';
+    bounds = malloc(sizeof(size_t) * (nthreads + 1));
+    bounds[0] = 0;
+
+    for (i = 1; i < nthreads; i ++) {
+	b = length / nthreads * i;
+
+	if (b < bounds[i - 1])
+	    b = bounds[i - 1];
+
+	while (b < length && !isspace((unsigned char) text[b]))
+	    b ++;
+
+	bounds[i] = b < length ? b + 1 : length;
+    }
+
+    bounds[nthreads] = length;
+}
+
+
+/*
+ * Function:	countParallel
+ *
+ * Description:	Count and print the words in the open file FP using
+ *		nthreads threads.
+ */
+
+static void countParallel(FILE *fp)
+{
+    pthread_t threads[MAX_THREADS];
+    long i;
+
+
+    readText(fp);
+    shards = malloc(sizeof(MAP **) * nthreads);
+
+    for (i = 0; i < nthreads; i ++)
+	pthread_create(&threads[i], NULL, countChunk, (void *) i);
+
+    for (i = 0; i < nthreads; i ++)
+	pthread_join(threads[i], NULL);
+
+    for (i = 0; i < nthreads; i ++)
+	pthread_create(&threads[i], NULL, mergeShard, (void *) i);
+
+    for (i = 0; i < nthreads; i ++)
+	pthread_join(threads[i], NULL);
+
+    for (i = 0; i < nthreads; i ++) {
+	forEachEntry(shards[0][i], printWord, NULL);
+	destroyMap(shards[0][i]);
+    }
+
+    for (i = 0; i < nthreads; i ++)
+	free(shards[i]);
+
+    free(shards);
+    free(bounds);
+    free(text);
 }
 
 
@@ -79,15 +281,21 @@ int main(int argc, char *argv[])
 {
     FILE *fp;
     char buffer[BUFSIZ];
-    struct entry e, *ep, **entries;
-    SET *counts;
-    int i;
+    MAP *counts;
 
 
     /* Check usage and open the file. */
 
-    if (argc != 2) {
-        fprintf(stderr, "usage: %s file\n", argv[0]);
+    nthreads = 1;
+
+    if (argc == 4 && strcmp(argv[1], "-j") == 0) {
+	nthreads = atoi(argv[2]);
+	argc -= 2;
+	argv[1] = argv[3];
+    }
+
+    if (argc != 2 || nthreads < 1 || nthreads > MAX_THREADS) {
+        fprintf(stderr, "usage: %s [-j threads] file\n", argv[0]);
         exit(EXIT_FAILURE);
     }
 
@@ -97,41 +305,27 @@ int main(int argc, char *argv[])
     }
 
 
-    /* Increment the count on each word read. */
-
-    counts = createSet(MAX_SIZE, compareEntries, hashEntry);
+    /* Count in parallel if requested. */
 
-    while (fscanf(fp, "%s", buffer) == 1) {
-	e.word = buffer;
-	ep = findElement(counts, &e);
+    if (nthreads > 1) {
+	countParallel(fp);
+	fclose(fp);
+	exit(EXIT_SUCCESS);
+    }
 
-	if (ep == NULL) {
-	    ep = malloc(sizeof(struct entry));
-	    assert(ep != NULL);
 
-	    ep->word = strdup(buffer);
-	    assert(ep->word != NULL);
+    /* Increment the count on each word read. */
 
-	    ep->count = 1;
-	    addElement(counts, ep);
+    counts = createMap(MAX_SIZE, strcmp, strhash);
 
-	} else
-	    ep->count ++;
-    }
+    while (fscanf(fp, "%s", buffer) == 1)
+	(*upsert(counts, buffer, copyWord)) ++;
 
 
     /* Print out the counts for each word. */
 
-    entries = getElements(counts);
-
-    for (i = 0; i < numElements(counts); i ++) {
-	printf("%s: %d\n", entries[i]->word, entries[i]->count);
-	free(entries[i]->word);
-	free(entries[i]);
-    }
-
-    free(entries);
+    forEachEntry(counts, printEntry, NULL);
 
-    destroySet(counts);
+    destroyMap(counts);
     exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,479 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 11/30/2025
+ *
+ * cuckoo.c
+ * Implementation of a generic hash table using bucketized cuckoo hashing.
+ * The table is an array of buckets of SLOTS slots each, and every element
+ * lives in one of two buckets chosen by two different mixes of its hash,
+ * so a lookup reads at most two buckets. Each bucket is one 64 byte cache
+ * line holding the elements and their full hashes, and the compare function
+ * only runs on slots whose stored hash matches.
+ *
+ * An insertion that finds both buckets full moves an element out of one of
+ * them to its other bucket, repeating up to MAX_KICKS times. An element
+ * still without a slot after that goes to a small stash, which lookups also
+ * check. The table doubles once the buckets are nine tenths full, or once
+ * the stash holds more than STASH elements while the buckets are at least
+ * half full. Since both buckets come from the same 32 bit hash, elements
+ * with equal hashes always share their buckets, and any beyond 2 * SLOTS of
+ * them stay in the stash, as growing the table would not separate them.
+ *
+ * Removing an element just empties its slot, so there are no Deleted
+ * markers and removals never slow down later lookups.
+ *
+ * Big O Time Complexities:
+ * createSet: O(m) - where m is maxElts
+ * destroySet: O(1)
+ * numElements: O(1)
+ * addElement: O(1) amortized average, O(m) worst case
+ * upsertElement: O(1) amortized average, O(m) worst case
+ * toggleElement: O(1) amortized average, O(m) worst case
+ * removeElement: O(1) worst case apart from the stash
+ * findElement: O(1) worst case apart from the stash
+ * findElements: O(n) - where n is the batch size
+ * getElements: O(m)
+ * firstElement: O(m) worst case
+ * nextElement: O(m) worst case, O(m) for a whole iteration
+ * search: O(1) worst case apart from the stash
+ * place: O(MAX_KICKS)
+ * grow: O(m) expected
+ * insert: O(1) amortized average, O(m) worst case
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "set.h"
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#define SLOTS 4
+#define MAX_KICKS 500	/* displacements tried before using the stash */
+#define STASH 8		/* stash size that forces the table to grow */
+#define BATCH 16	/* keys hashed and prefetched together by findElements */
+
+struct bucket {
+	unsigned hashes[SLOTS];
+	void *elts[SLOTS];	/* NULL if the slot is empty */
+} __attribute__((aligned(64)));
+
+struct entry {
+	unsigned hash;
+	void *elt;
+};
+
+typedef struct set {
+	size_t count;
+	size_t length;		/* number of buckets, a power of two */
+	struct bucket *buckets;
+	struct entry *stash;
+	size_t stashed;		/* elements in the stash */
+	size_t stashLength;	/* capacity of the stash */
+	size_t kicks;		/* total displacements, used to pick victims */
+	size_t cursor;		/* next slot to visit while iterating */
+	int (*compare)();
+	unsigned (*hash)();
+} SET;
+
+static long search(SET *sp, void *elt, unsigned hash);
+
+/* private helper: scramble a hash so that all of its bits affect the
+ * bucket chosen.
+ * Big O: O(1)
+ */
+static unsigned mix(unsigned hash) {
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+/* private helper: return the first bucket for an element with hash.
+ * Big O: O(1)
+ */
+static size_t first(SET *sp, unsigned hash) {
+	return mix(hash) & (sp->length - 1);
+}
+
+/* private helper: return the second bucket for an element with hash, using
+ * a different mix from the first.
+ * Big O: O(1)
+ */
+static size_t second(SET *sp, unsigned hash) {
+	return mix(hash ^ 0x9e3779b9) & (sp->length - 1);
+}
+
+/* private helper: return the address of the slot at index idx, where the
+ * slots of the buckets come first and then those of the stash.
+ * Big O: O(1)
+ */
+static void **slotAt(SET *sp, size_t idx) {
+	size_t slots = sp->length * SLOTS;
+	if (idx < slots) {
+		return &sp->buckets[idx / SLOTS].elts[idx % SLOTS];
+	}
+	return &sp->stash[idx - slots].elt;
+}
+
+/* private helper: allocate length empty buckets.
+ * Big O: O(m)
+ */
+static void initTable(SET *sp, size_t length) {
+	sp->length = length;
+	sp->buckets = aligned_alloc(64, sizeof(struct bucket) * length);
+	assert(sp->buckets != NULL);
+	memset(sp->buckets, 0, sizeof(struct bucket) * length);
+}
+
+/* private helper: add elt with hash to the stash, growing it if needed.
+ * Big O: O(1) amortized
+ */
+static void stashElement(SET *sp, void *elt, unsigned hash) {
+	if (sp->stashed == sp->stashLength) {
+		sp->stashLength = sp->stashLength > 0 ? sp->stashLength * 2 : STASH;
+		sp->stash = realloc(sp->stash, sizeof(struct entry) * sp->stashLength);
+		assert(sp->stash != NULL);
+	}
+	sp->stash[sp->stashed].hash = hash;
+	sp->stash[sp->stashed].elt = elt;
+	sp->stashed++;
+}
+
+/* private helper: store elt with hash in an empty slot of bucket b and
+ * return true, or return false if the bucket is full.
+ * Big O: O(1)
+ */
+static bool fill(SET *sp, size_t b, void *elt, unsigned hash) {
+	struct bucket *bp = &sp->buckets[b];
+	for (int i = 0; i < SLOTS; i++) {
+		if (bp->elts[i] == NULL) {
+			bp->hashes[i] = hash;
+			bp->elts[i] = elt;
+			return true;
+		}
+	}
+	return false;
+}
+
+/* private helper: store elt, which is known to be absent, in one of its two
+ * buckets. If both are full, an element of the bucket it did not just come
+ * from is swapped out and placed in turn, so each displaced element moves
+ * to its other bucket. After MAX_KICKS displacements the element left over
+ * goes to the stash. Returns true if the stash was used.
+ * Big O: O(MAX_KICKS)
+ */
+static bool place(SET *sp, void *elt, unsigned hash) {
+	size_t from = sp->length;
+	for (int k = 0; k < MAX_KICKS; k++) {
+		size_t b1 = first(sp, hash), b2 = second(sp, hash);
+		if (fill(sp, b1, elt, hash) || fill(sp, b2, elt, hash)) {
+			return false;
+		}
+		size_t b = from == b1 ? b2 : b1;
+		int i = sp->kicks++ % SLOTS;
+		void *victim = sp->buckets[b].elts[i];
+		unsigned victimHash = sp->buckets[b].hashes[i];
+		sp->buckets[b].elts[i] = elt;
+		sp->buckets[b].hashes[i] = hash;
+		elt = victim;
+		hash = victimHash;
+		from = b;
+	}
+	stashElement(sp, elt, hash);
+	return true;
+}
+
+/* private helper: rebuild the table with twice as many buckets, placing
+ * the elements of the old buckets and of the stash again.
+ * Big O: O(m) expected
+ */
+static void grow(SET *sp) {
+	struct bucket *old = sp->buckets;
+	size_t oldLength = sp->length;
+	struct entry *stash = sp->stash;
+	size_t stashed = sp->stashed;
+	initTable(sp, oldLength * 2);
+	sp->stash = NULL;
+	sp->stashed = sp->stashLength = 0;
+	for (size_t b = 0; b < oldLength; b++) {
+		for (int i = 0; i < SLOTS; i++) {
+			if (old[b].elts[i] != NULL) {
+				place(sp, old[b].elts[i], old[b].hashes[i]);
+			}
+		}
+	}
+	for (size_t j = 0; j < stashed; j++) {
+		place(sp, stash[j].elt, stash[j].hash);
+	}
+	free(old);
+	free(stash);
+}
+
+/* createSet: allocate and initialize a new cuckoo hash table SET with room
+ * for at least maxElts elements before it has to grow. Stores function
+ * pointers for comparison and hashing.
+ * Big O: O(m)
+ */
+SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()) {
+	SET *sp;
+	size_t length = 1;
+	assert(maxElts > 0);
+	assert(compare != NULL && hash != NULL);
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	while (length * SLOTS * 9 / 10 < maxElts) {
+		length *= 2;
+	}
+	sp->count = 0;
+	sp->stash = NULL;
+	sp->stashed = 0;
+	sp->stashLength = 0;
+	sp->kicks = 0;
+	sp->cursor = 0;
+	sp->compare = compare;
+	sp->hash = hash;
+	initTable(sp, length);
+	return sp;
+}
+
+/* destroySet: free the buckets, the stash, and the set structure.
+ * Does NOT free individual elements as the caller retains ownership of the data.
+ * Big O: O(1)
+ */
+void destroySet(SET *sp) {
+	assert(sp != NULL);
+	free(sp->buckets);
+	free(sp->stash);
+	free(sp);
+}
+
+/* numElements: return the number of elements stored
+ * Big O: O(1)
+ */
+int numElements(SET *sp) {
+	assert(sp != NULL);
+	return sp->count;
+}
+
+/* addElement: insert elt in the table if no equal element is present.
+ * Stores the pointer directly without copying.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void addElement(SET *sp, void *elt) {
+	bool found;
+	upsertElement(sp, elt, &found);
+}
+
+/* private helper: add elt, which is known to be absent, and return the
+ * address of the slot it ends up in. The table grows first if the buckets
+ * are nine tenths full, and again afterwards if the stash is too large and
+ * the buckets are at least half full, since at a lower load the stash can
+ * only hold elements with colliding hashes.
+ * Since placing elt may move it again, its slot is found by address once
+ * it has settled.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+static void **insert(SET *sp, void *elt, unsigned hash) {
+	if ((sp->count + 1) * 10 > sp->length * SLOTS * 9) {
+		grow(sp);
+	}
+	if (place(sp, elt, hash) && sp->stashed > STASH &&
+	    sp->count * 2 >= sp->length * SLOTS) {
+		grow(sp);
+	}
+	sp->count++;
+	struct bucket *b1 = &sp->buckets[first(sp, hash)];
+	struct bucket *b2 = &sp->buckets[second(sp, hash)];
+	for (int i = 0; i < SLOTS; i++) {
+		if (b1->elts[i] == elt) {
+			return &b1->elts[i];
+		}
+		if (b2->elts[i] == elt) {
+			return &b2->elts[i];
+		}
+	}
+	for (size_t j = 0; j < sp->stashed; j++) {
+		if (sp->stash[j].elt == elt) {
+			return &sp->stash[j].elt;
+		}
+	}
+	assert(false);
+	return NULL;
+}
+
+/* private helper: empty the slot at index idx. A stash slot is filled with
+ * the last element of the stash.
+ * Big O: O(1)
+ */
+static void erase(SET *sp, size_t idx) {
+	size_t slots = sp->length * SLOTS;
+	if (idx < slots) {
+		sp->buckets[idx / SLOTS].elts[idx % SLOTS] = NULL;
+	}
+	else {
+		sp->stash[idx - slots] = sp->stash[--sp->stashed];
+	}
+	sp->count--;
+}
+
+/* upsertElement: find or insert elt with a single hash. If an equal element
+ * is present, *found is set to true and the address of its slot is
+ * returned. Otherwise elt itself is inserted, *found is set to false, and
+ * the address of the new slot is returned so the caller can replace elt
+ * with an equal element it owns before the next operation on the set.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void **upsertElement(SET *sp, void *elt, bool *found) {
+	assert((elt != NULL) && (sp != NULL) && (found != NULL));
+	unsigned hash = (*sp->hash)(elt);
+	long idx = search(sp, elt, hash);
+	if ((*found = idx != -1)) {
+		return slotAt(sp, idx);
+	}
+	return insert(sp, elt, hash);
+}
+
+/* toggleElement: insert elt if no equal element is present, or remove the
+ * equal element if there is one, using a single hash. On removal the
+ * removed element is stored in *removed and NULL is returned, so the
+ * caller can free it. On insertion the address of the new slot is
+ * returned, so the caller can replace elt with an equal element it owns
+ * before the next operation on the set, as with upsertElement.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void **toggleElement(SET *sp, void *elt, void **removed) {
+	assert((elt != NULL) && (sp != NULL) && (removed != NULL));
+	unsigned hash = (*sp->hash)(elt);
+	long idx = search(sp, elt, hash);
+	if (idx != -1) {
+		*removed = *slotAt(sp, idx);
+		erase(sp, idx);
+		return NULL;
+	}
+	return insert(sp, elt, hash);
+}
+
+/* removeElement: remove elt from the table if present by emptying its
+ * slot. Does NOT free the element as caller owns the data.
+ * Big O: O(1) worst case apart from the stash
+ */
+void removeElement(SET *sp, void *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	long idx = search(sp, elt, (*sp->hash)(elt));
+	if (idx != -1) {
+		erase(sp, idx);
+	}
+}
+
+/* findElement: return pointer to stored element equal to elt, or NULL if
+ * not found.
+ * Big O: O(1) worst case apart from the stash
+ */
+void *findElement(SET *sp, void *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	long idx = search(sp, elt, (*sp->hash)(elt));
+	return idx != -1 ? *slotAt(sp, idx) : NULL;
+}
+
+/* findElements: look up the n elements of elts and store the match for
+ * each (or NULL) in the same position of matches. Keys are handled BATCH
+ * at a time: all of them are hashed and both of their buckets prefetched
+ * before any searching starts.
+ * Big O: O(n) - where n is the batch size
+ */
+void findElements(SET *sp, void **elts, int n, void **matches) {
+	assert((sp != NULL) && (elts != NULL) && (matches != NULL));
+	unsigned hashes[BATCH];
+	int i, j, m;
+	long idx;
+	for (i = 0; i < n; i += BATCH) {
+		m = n - i < BATCH ? n - i : BATCH;
+		for (j = 0; j < m; j++) {
+			assert(elts[i + j] != NULL);
+			hashes[j] = (*sp->hash)(elts[i + j]);
+			__builtin_prefetch(&sp->buckets[first(sp, hashes[j])]);
+			__builtin_prefetch(&sp->buckets[second(sp, hashes[j])]);
+		}
+		for (j = 0; j < m; j++) {
+			idx = search(sp, elts[i + j], hashes[j]);
+			matches[i + j] = idx != -1 ? *slotAt(sp, idx) : NULL;
+		}
+	}
+}
+
+/* getElements: return a newly-allocated array of generic pointers to the
+ * elements stored in the table.
+ * Big O: O(m)
+ */
+void *getElements(SET *sp) {
+	assert(sp != NULL);
+	void **cpy, *elt;
+	cpy = malloc(sp->count*sizeof(void *));
+	assert(cpy != NULL);
+	int j = 0;
+	size_t slots = sp->length * SLOTS + sp->stashed;
+	for (size_t i = 0; i < slots; i++) {
+		if ((elt = *slotAt(sp, i)) != NULL) {
+			cpy[j] = elt;
+			j++;
+		}
+	}
+	return cpy;
+}
+
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The buckets and then
+ * the stash are visited in place without allocating. The set must not be
+ * changed until nextElement returns NULL.
+ * Big O: O(m) worst case
+ */
+void *firstElement(SET *sp) {
+	assert(sp != NULL);
+	sp->cursor = 0;
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned.
+ * Big O: O(m) worst case, O(m) for a whole iteration
+ */
+void *nextElement(SET *sp) {
+	assert(sp != NULL);
+	void *elt;
+	while (sp->cursor < sp->length * SLOTS + sp->stashed) {
+		if ((elt = *slotAt(sp, sp->cursor++)) != NULL) {
+			return elt;
+		}
+	}
+	return NULL;
+}
+
+
+/* private helper: returns the index of the slot holding an element equal
+ * to elt, as used by slotAt, or -1 if there is none. Only the two buckets
+ * of elt and the stash are searched, and the compare function only runs
+ * when the stored hash matches.
+ * Big O: O(1) worst case apart from the stash
+ */
+static long search(SET *sp, void *elt, unsigned hash) {
+	size_t b[2] = { first(sp, hash), second(sp, hash) };
+	for (int k = 0; k < 2; k++) {
+		struct bucket *bp = &sp->buckets[b[k]];
+		for (int i = 0; i < SLOTS; i++) {
+			if (bp->elts[i] != NULL && bp->hashes[i] == hash &&
+			    (*sp->compare)(bp->elts[i], elt) == 0) {
+				return b[k] * SLOTS + i;
+			}
+		}
+	}
+	for (size_t j = 0; j < sp->stashed; j++) {
+		if (sp->stash[j].hash == hash && (*sp->compare)(sp->stash[j].elt, elt) == 0) {
+			return sp->length * SLOTS + j;
+		}
+	}
+	return -1;
+}
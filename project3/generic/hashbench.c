@@ -0,0 +1,291 @@
+/*
+ * File:        hashbench.c
+ *
+ * Description: This file contains the main function for comparing the
+ *              string hash functions in hashes.c.
+ *
+ *              The program takes one or more files as command line
+ *              arguments and reads all of their words.  For each hash
+ *              function, or only the one named with -h, it prints how
+ *              fast all words are hashed, in bytes per cycle and
+ *              nanoseconds per word, and the probe lengths that result
+ *              from inserting the distinct words into a linear probing
+ *              table of the size the generic set would use.
+ *
+ *              Cycles are read from the time stamp counter, which runs at
+ *              a fixed rate that may differ from the core clock, and are
+ *              only reported on x86.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdint.h>
+# include <time.h>
+# include "hashes.h"
+
+# if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+# define HAVE_TSC
+# endif
+
+
+/* This is sufficient for the test cases in /scratch/coen12. */
+
+# define MAX_SIZE 18000
+
+# define MIN_BYTES (64 << 20)		/* bytes hashed per timing */
+
+# define BUCKETS 16			/* last bucket counts longer probes */
+
+
+static char **words;
+static size_t *lengths;
+static int nwords;
+static char **keys;
+static int nkeys;
+
+
+/*
+ * Function:	compareWords
+ *
+ * Description:	Compare the strings pointed to by P and Q for qsort.
+ */
+
+static int compareWords(const void *p, const void *q)
+{
+    return strcmp(*(char **) p, *(char **) q);
+}
+
+
+/*
+ * Function:	readWords
+ *
+ * Description:	Read all words in the file named NAME into the words array,
+ *		exiting if the file cannot be opened.
+ */
+
+static void readWords(char *program, char *name)
+{
+    static int size;
+    char buffer[BUFSIZ];
+    FILE *fp;
+
+
+    if ((fp = fopen(name, "r")) == NULL) {
+	fprintf(stderr, "%s: cannot open %s\n", program, name);
+	exit(EXIT_FAILURE);
+    }
+
+    while (fscanf(fp, "%s", buffer) == 1) {
+	if (nwords == size) {
+	    size = size > 0 ? size * 2 : 1024;
+	    words = realloc(words, sizeof(char *) * size);
+	    lengths = realloc(lengths, sizeof(size_t) * size);
+	}
+
+	lengths[nwords] = strlen(buffer);
+	words[nwords ++] = strdup(buffer);
+    }
+
+    fclose(fp);
+}
+
+
+/*
+ * Function:	findKeys
+ *
+ * Description:	Fill the keys array with the distinct words.
+ */
+
+static void findKeys(void)
+{
+    int i;
+
+
+    keys = malloc(sizeof(char *) * (nwords > 0 ? nwords : 1));
+    memcpy(keys, words, sizeof(char *) * nwords);
+    qsort(keys, nwords, sizeof(char *), compareWords);
+
+    for (i = 0; i < nwords; i ++)
+	if (nkeys == 0 || strcmp(keys[nkeys - 1], keys[i]) != 0)
+	    keys[nkeys ++] = keys[i];
+}
+
+
+/*
+ * Function:	timeHash
+ *
+ * Description:	Hash all words with HASH until at least MIN_BYTES bytes
+ *		have been hashed, and print the rate.
+ */
+
+static void timeHash(const char *name, HASHFN hash)
+{
+    struct timespec start, stop;
+    size_t bytes = 0, hashed = 0;
+    volatile unsigned sink = 0;
+    double ns;
+    int i;
+# ifdef HAVE_TSC
+    uint64_t cycles;
+# endif
+
+
+    for (i = 0; i < nwords; i ++)
+	bytes += lengths[i];
+
+    if (bytes == 0)
+	return;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+# ifdef HAVE_TSC
+    cycles = __rdtsc();
+# endif
+
+    while (hashed < MIN_BYTES) {
+	for (i = 0; i < nwords; i ++)
+	    sink += (*hash)(words[i], lengths[i]);
+
+	hashed += bytes;
+    }
+
+# ifdef HAVE_TSC
+    cycles = __rdtsc() - cycles;
+# endif
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    ns = (stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec);
+    printf("%s: %.2f ns/word", name, ns / (hashed / bytes) / nwords);
+# ifdef HAVE_TSC
+    printf(", %.2f bytes/cycle", (double) hashed / cycles);
+# endif
+    printf("\n");
+}
+
+
+/*
+ * Function:	probeHash
+ *
+ * Description:	Insert the distinct words with HASH into a linear probing
+ *		table as large as the generic set would make it, and print
+ *		the distribution of probe lengths, counted as the slots
+ *		examined after the home slot.  The mean for misses is over
+ *		all home slots.
+ */
+
+static void probeHash(const char *name, HASHFN hash)
+{
+    unsigned long hist[BUCKETS];
+    size_t length, locn, probes, longest, hits, misses, run, i;
+    char *used;
+    int k;
+
+
+    length = MAX_SIZE;
+
+    while ((size_t) nkeys * 4 > length * 3)
+	length *= 2;
+
+    used = calloc(length, 1);
+    memset(hist, 0, sizeof(hist));
+    longest = hits = 0;
+
+    for (k = 0; k < nkeys; k ++) {
+	locn = (*hash)(keys[k], strlen(keys[k])) % length;
+
+	for (probes = 0; used[locn]; probes ++)
+	    locn = locn + 1 == length ? 0 : locn + 1;
+
+	used[locn] = 1;
+	hist[probes < BUCKETS - 1 ? probes : BUCKETS - 1] ++;
+	hits += probes;
+
+	if (probes > longest)
+	    longest = probes;
+    }
+
+
+    /* Walk backwards from an empty slot, finding the run length of used
+       slots that starts at each slot. */
+
+    for (i = 0; used[i]; i ++)
+	;
+
+    misses = run = 0;
+
+    for (locn = i == 0 ? length - 1 : i - 1; locn != i;
+	    locn = locn == 0 ? length - 1 : locn - 1) {
+	run = used[locn] ? run + 1 : 0;
+	misses += run;
+    }
+
+    printf("%s: %d keys in %zu slots, mean probe %.3f hit %.3f miss, longest %zu\n",
+	name, nkeys, length, nkeys > 0 ? (double) hits / nkeys : 0.0,
+	(double) misses / length, longest);
+
+    printf("%s: hits by probe length:", name);
+
+    for (k = 0; k < BUCKETS; k ++)
+	printf(" %lu", hist[k]);
+
+    printf("\n");
+    free(used);
+}
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the benchmark.
+ */
+
+int main(int argc, char *argv[])
+{
+    char *only = NULL;
+    int i;
+
+
+    /* Check usage and read the files. */
+
+    if (argc > 2 && strcmp(argv[1], "-h") == 0) {
+	only = argv[2];
+	argc -= 2;
+
+	for (i = 1; i < argc; i ++)
+	    argv[i] = argv[i + 2];
+    }
+
+    if (argc == 1 || (only != NULL && findHash(only) == NULL)) {
+	fprintf(stderr, "usage: %s [-h hash] file ...\n", argv[0]);
+	fprintf(stderr, "hashes:");
+
+	for (i = 0; hashFunctions[i].name != NULL; i ++)
+	    fprintf(stderr, " %s", hashFunctions[i].name);
+
+	fprintf(stderr, "\n");
+	exit(EXIT_FAILURE);
+    }
+
+    for (i = 1; i < argc; i ++)
+	readWords(argv[0], argv[i]);
+
+    findKeys();
+
+
+    /* Time each hash function and find its probe lengths. */
+
+    for (i = 0; hashFunctions[i].name != NULL; i ++)
+	if (only == NULL || strcmp(only, hashFunctions[i].name) == 0) {
+	    timeHash(hashFunctions[i].name, hashFunctions[i].hash);
+	    probeHash(hashFunctions[i].name, hashFunctions[i].hash);
+	}
+
+    for (i = 0; i < nwords; i ++)
+	free(words[i]);
+
+    free(words);
+    free(lengths);
+    free(keys);
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,195 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 11/23/2025
+ *
+ * hashes.c
+ * A family of string hash functions over keys of known length, for use with
+ * the sets and maps in this directory:
+ *
+ * legacy: the byte at a time hash 31 * hash + c used by the drivers. Its low
+ * bits depend mostly on the last few bytes, so it clusters under % length.
+ * word: reads the key eight bytes at a time, combining each word with a
+ * rotate, xor, and multiply, then mixes the high bits down so that % length
+ * sees all of them.
+ * wy: a wyhash style hash that folds sixteen bytes at a time through a full
+ * 64 by 64 to 128 bit multiply, and reads short keys with a few overlapping
+ * loads instead of a loop.
+ *
+ * The word and wy hashes read the key with memcpy, so keys need not be
+ * aligned, and their values depend on the byte order of the machine.
+ *
+ * Big O Time Complexities:
+ * legacyHash: O(n) where n is the key length
+ * wordHash: O(n) where n is the key length
+ * wyHash: O(n) where n is the key length
+ * findHash: O(1)
+ * selectHash: O(1)
+ * hashString: O(n) where n is the string length
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "hashes.h"
+
+#define WORD_MUL 0x9E3779B97F4A7C15ull	/* 2^64 divided by the golden ratio */
+
+#define WY_P0 0xa0761d6478bd642full
+#define WY_P1 0xe7037ed1a0b428dbull
+#define WY_P2 0x8ebc6af09c88c6e3ull
+
+const struct hashfn hashFunctions[] = {
+	{ "legacy", legacyHash },
+	{ "word", wordHash },
+	{ "wy", wyHash },
+	{ NULL, NULL },
+};
+
+static HASHFN selected = legacyHash;
+
+/* private helper: return the eight bytes at p as a word.
+ * Big O: O(1)
+ */
+static inline uint64_t read8(const unsigned char *p) {
+	uint64_t w;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
+
+/* private helper: return the four bytes at p as a word.
+ * Big O: O(1)
+ */
+static inline uint64_t read4(const unsigned char *p) {
+	uint32_t w;
+	memcpy(&w, p, sizeof(w));
+	return w;
+}
+
+/* private helper: multiply a and b to 128 bits and return the xor of the two
+ * halves of the product.
+ * Big O: O(1)
+ */
+static inline uint64_t mix(uint64_t a, uint64_t b) {
+	unsigned __int128 r = (unsigned __int128) a * b;
+	return (uint64_t) r ^ (uint64_t) (r >> 64);
+}
+
+/* legacyHash: return the hash 31 * hash + c over the bytes of key, the same
+ * value the drivers' strhash computes for a null terminated string.
+ * Big O: O(n) where n is the key length
+ */
+unsigned legacyHash(const void *key, size_t length) {
+	const char *s = key;
+	unsigned hash = 0;
+	for (size_t i = 0; i < length; i++) {
+		hash = 31 * hash + s[i];
+	}
+	return hash;
+}
+
+/* wordHash: return a hash of key computed a word at a time. A last partial
+ * word is read with overlapping loads rather than byte by byte, and since the
+ * length is mixed in first, keys whose loads happen to match still differ.
+ * Big O: O(n) where n is the key length
+ */
+unsigned wordHash(const void *key, size_t length) {
+	const unsigned char *p = key;
+	uint64_t hash = length * WORD_MUL;
+	uint64_t w;
+	size_t i;
+	for (i = 0; i + 8 <= length; i += 8) {
+		hash = (((hash << 5) | (hash >> 59)) ^ read8(p + i)) * WORD_MUL;
+	}
+	if (i < length) {
+		if (length >= 8) {
+			w = read8(p + length - 8);
+		}
+		else if (length >= 4) {
+			w = (read4(p) << 32) | read4(p + length - 4);
+		}
+		else {
+			w = ((uint64_t) p[0] << 16) | ((uint64_t) p[length >> 1] << 8) | p[length - 1];
+		}
+		hash = (((hash << 5) | (hash >> 59)) ^ w) * WORD_MUL;
+	}
+	hash = (hash ^ (hash >> 32)) * WORD_MUL;
+	return hash >> 32;
+}
+
+/* wyHash: return a wyhash style hash of key. Keys of up to sixteen bytes are
+ * read with at most four overlapping loads, and longer keys sixteen bytes at
+ * a time, ending with the last sixteen bytes of the key.
+ * Big O: O(n) where n is the key length
+ */
+unsigned wyHash(const void *key, size_t length) {
+	const unsigned char *p = key;
+	uint64_t seed = mix(WY_P0, WY_P1);
+	uint64_t a, b;
+	if (length <= 16) {
+		if (length >= 4) {
+			size_t k = (length >> 3) << 2;
+			a = (read4(p) << 32) | read4(p + k);
+			b = (read4(p + length - 4) << 32) | read4(p + length - 4 - k);
+		}
+		else if (length > 0) {
+			a = ((uint64_t) p[0] << 16) | ((uint64_t) p[length >> 1] << 8) | p[length - 1];
+			b = 0;
+		}
+		else {
+			a = b = 0;
+		}
+	}
+	else {
+		size_t i = length;
+		while (i > 16) {
+			seed = mix(read8(p) ^ WY_P1, read8(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = read8(p + i - 16);
+		b = read8(p + i - 8);
+	}
+	uint64_t hash = mix(WY_P1 ^ length, mix(a ^ WY_P1, b ^ seed) ^ WY_P2);
+	return hash ^ (hash >> 32);
+}
+
+/* findHash: return the hash function called name, or NULL if there is none.
+ * Big O: O(1)
+ */
+HASHFN findHash(const char *name) {
+	assert(name != NULL);
+	for (int i = 0; hashFunctions[i].name != NULL; i++) {
+		if (strcmp(hashFunctions[i].name, name) == 0) {
+			return hashFunctions[i].hash;
+		}
+	}
+	return NULL;
+}
+
+/* selectHash: make the hash function called name the one used by hashString.
+ * If name is NULL then the STRHASH environment variable is used instead, and
+ * if it is not set either the legacy hash is kept. Returns false if there is
+ * no hash function with the given name.
+ * Big O: O(1)
+ */
+bool selectHash(const char *name) {
+	HASHFN hash;
+	if (name == NULL && (name = getenv("STRHASH")) == NULL) {
+		return true;
+	}
+	if ((hash = findHash(name)) == NULL) {
+		return false;
+	}
+	selected = hash;
+	return true;
+}
+
+/* hashString: return the value of the selected hash function for the null
+ * terminated string s, for use as the hash function of a set or map.
+ * Big O: O(n) where n is the string length
+ */
+unsigned hashString(char *s) {
+	return (*selected)(s, strlen(s));
+}
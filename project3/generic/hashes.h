@@ -0,0 +1,40 @@
+/*
+ * File:        hashes.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for a family of string hash functions.  Each
+ *              hash function takes a key and its length in bytes, so keys
+ *              need not be null terminated.
+ *
+ *              The hash function used by hashString is chosen by name with
+ *              selectHash, or from the STRHASH environment variable.
+ */
+
+# ifndef HASHES_H
+# define HASHES_H
+
+# include <stdbool.h>
+# include <stddef.h>
+
+typedef unsigned (*HASHFN)(const void *key, size_t length);
+
+struct hashfn {
+    const char *name;
+    HASHFN hash;
+};
+
+extern const struct hashfn hashFunctions[];	/* ends with a null name */
+
+unsigned legacyHash(const void *key, size_t length);
+
+unsigned wordHash(const void *key, size_t length);
+
+unsigned wyHash(const void *key, size_t length);
+
+HASHFN findHash(const char *name);
+
+bool selectHash(const char *name);
+
+unsigned hashString(char *s);
+
+# endif /* HASHES_H */
@@ -0,0 +1,176 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 10/19/2025
+ *
+ * map.c
+ * Implementation of a map from generic keys to integer values using a
+ * hash table with open addressing and linear probing. Each slot holds a
+ * key pointer and its value side by side, so a lookup that finds the key
+ * already has the value in the same cache line. A slot with a NULL key is
+ * empty. The table doubles in size once it is three quarters full.
+ *
+ * Big O Time Complexities:
+ * createMap: O(m) - where m is maxElts
+ * destroyMap: O(1)
+ * numEntries: O(1)
+ * findValue: O(1) average, O(m) worst case
+ * upsert: O(1) amortized average, O(m) worst case
+ * forEachEntry: O(m)
+ * search: O(1) average, O(m) worst case
+ * grow: O(m)
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "map.h"
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+
+struct slot {
+	void *key;
+	int value;
+};
+
+typedef struct map {
+	size_t count;
+	size_t length;
+	struct slot *slots;
+	int (*compare)();
+	unsigned (*hash)();
+} MAP;
+
+static size_t search(MAP *mp, void *key, unsigned hash, bool *found);
+
+/* private helper: allocate length empty slots for the map.
+ * Big O: O(m)
+ */
+static void initSlots(MAP *mp, size_t length) {
+	mp->length = length;
+	mp->slots = calloc(length, sizeof(struct slot));
+	assert(mp->slots != NULL);
+}
+
+/* private helper: move every entry into a table twice as large.
+ * Big O: O(m)
+ */
+static void grow(MAP *mp) {
+	struct slot *old = mp->slots;
+	size_t oldLength = mp->length;
+	bool found;
+	initSlots(mp, oldLength * 2);
+	for (size_t i = 0; i < oldLength; i++) {
+		if (old[i].key != NULL) {
+			size_t locn = search(mp, old[i].key, (*mp->hash)(old[i].key), &found);
+			mp->slots[locn] = old[i];
+		}
+	}
+	free(old);
+}
+
+/* createMap: allocate and initialize a new MAP with an initial capacity of
+ * maxElts entries. Stores function pointers for comparing and hashing keys.
+ * Big O: O(m)
+ */
+MAP *createMap(int maxElts, int (*compare)(), unsigned (*hash)()) {
+	MAP *mp;
+	assert(maxElts > 0);
+	assert(compare != NULL && hash != NULL);
+	mp = malloc(sizeof(MAP));
+	assert(mp != NULL);
+	mp->count = 0;
+	mp->compare = compare;
+	mp->hash = hash;
+	initSlots(mp, maxElts);
+	return mp;
+}
+
+/* destroyMap: free the slot array and the map structure. Does NOT free the
+ * keys as the caller retains ownership of them.
+ * Big O: O(1)
+ */
+void destroyMap(MAP *mp) {
+	assert(mp != NULL);
+	free(mp->slots);
+	free(mp);
+}
+
+/* numEntries: return the number of entries stored
+ * Big O: O(1)
+ */
+int numEntries(MAP *mp) {
+	assert(mp != NULL);
+	return mp->count;
+}
+
+/* findValue: return the address of the value stored with key, or NULL if
+ * key is not present. The address is valid until the next upsert.
+ * Big O: O(1) average case, O(m) worst case
+ */
+int *findValue(MAP *mp, void *key) {
+	assert((mp != NULL) && (key != NULL));
+	bool found;
+	size_t locn = search(mp, key, (*mp->hash)(key), &found);
+	return found ? &mp->slots[locn].value : NULL;
+}
+
+/* upsert: return the address of the value stored with key, adding a new
+ * entry with a value of zero if key is not present. A new entry stores the
+ * result of (*copy)(key), or key itself if copy is NULL, and the copy is
+ * only made for new keys. The address is valid until the next upsert.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+int *upsert(MAP *mp, void *key, void *(*copy)()) {
+	assert((mp != NULL) && (key != NULL));
+	bool found;
+	unsigned hash = (*mp->hash)(key);
+	size_t locn = search(mp, key, hash, &found);
+	if (!found) {
+		if ((mp->count + 1) * 4 > mp->length * 3) {
+			grow(mp);
+			locn = search(mp, key, hash, &found);
+		}
+		if (copy != NULL) {
+			key = (*copy)(key);
+			assert(key != NULL);
+		}
+		mp->slots[locn].key = key;
+		mp->slots[locn].value = 0;
+		mp->count++;
+	}
+	return &mp->slots[locn].value;
+}
+
+/* forEachEntry: call (*visit)(key, value, arg) for every entry in the map,
+ * in no particular order. The visit function must not change the map.
+ * Big O: O(m)
+ */
+void forEachEntry(MAP *mp, void (*visit)(), void *arg) {
+	assert((mp != NULL) && (visit != NULL));
+	for (size_t i = 0; i < mp->length; i++) {
+		if (mp->slots[i].key != NULL) {
+			(*visit)(mp->slots[i].key, mp->slots[i].value, arg);
+		}
+	}
+}
+
+
+/* private helper: returns the index of key in the map or the index of the
+ * empty slot where it would be inserted, found using linear probing from
+ * the hash value. The table is never full, so an empty slot always ends
+ * the search.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static size_t search(MAP *mp, void *key, unsigned hash, bool *found) {
+	size_t locn = hash % mp->length;
+	while (mp->slots[locn].key != NULL) {
+		if ((*mp->compare)(mp->slots[locn].key, key) == 0) {
+			*found = true;
+			return locn;
+		}
+		locn = (locn + 1) % mp->length;
+	}
+	*found = false;
+	return locn;
+}
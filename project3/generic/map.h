@@ -0,0 +1,27 @@
+/*
+ * File:        map.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for a map abstract data type from generic
+ *              pointer keys to integer values.  A map is an unordered
+ *              collection of entries with distinct keys.
+ */
+
+# ifndef MAP_H
+# define MAP_H
+
+typedef struct map MAP;
+
+MAP *createMap(int maxElts, int (*compare)(), unsigned (*hash)());
+
+void destroyMap(MAP *mp);
+
+int numEntries(MAP *mp);
+
+int *findValue(MAP *mp, void *key);
+
+int *upsert(MAP *mp, void *key, void *(*copy)());
+
+void forEachEntry(MAP *mp, void (*visit)(), void *arg);
+
+# endif /* MAP_H */
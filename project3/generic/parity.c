@@ -10,12 +10,16 @@
  *              A set is used to maintain a collection of words that occur
  *              an odd number of times.  The counts of total words and
  *              words appearing an odd number of times are printed.
+ *
+ *              The string hash function is chosen by the STRHASH
+ *              environment variable, and defaults to the legacy hash.
  */
 
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
 # include "set.h"
+# include "hashes.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -23,24 +27,6 @@
 # define MAX_SIZE 18000
 
 
-/*
- * Function:    strhash
- *
- * Description: Return a hash value for a string S.
- */
-
-static unsigned strhash(char *s)
-{
-    unsigned hash = 0;
-
-
-    while (*s != '\0')
-        hash = 31 * hash + *s ++;
-
-    return hash;
-}
-
-
 /*
  * Function:    main
  *
@@ -51,6 +37,7 @@ int main(int argc, char *argv[])
 {
     FILE *fp;
     char buffer[BUFSIZ], *word;
+    void *removed;
     SET *odd;
     int words;
 
@@ -62,6 +49,11 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    if (!selectHash(NULL)) {
+        fprintf(stderr, "%s: unknown hash function %s\n", argv[0], getenv("STRHASH"));
+        exit(EXIT_FAILURE);
+    }
+
     if ((fp = fopen(argv[1], "r")) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
@@ -71,16 +63,17 @@ int main(int argc, char *argv[])
     /* Insert or delete words to compute their parity. */
 
     words = 0;
-    odd = createSet(MAX_SIZE, strcmp, strhash);
+    odd = createSet(MAX_SIZE, strcmp, hashString);
 
     while (fscanf(fp, "%s", buffer) == 1) {
         words ++;
 
-        if ((word = findElement(odd, buffer)) != NULL) {
-            removeElement(odd, buffer);
+	word = strdup(buffer);
+
+        if (toggleElement(odd, word, &removed) == NULL) {
+	    free(removed);
 	    free(word);
-	} else
-            addElement(odd, strdup(buffer));
+	}
     }
 
     printf("%d total words\n", words);
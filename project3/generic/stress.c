@@ -0,0 +1,201 @@
+/*
+ * File:        stress.c
+ *
+ * Description: This file contains the main function for checking that
+ *              lookups in a set abstract data type shared between threads
+ *              never miss while the set grows.
+ *
+ *              A set is created small and KEPT keys are inserted.  Then
+ *              WRITERS threads each insert the same ADDED more keys,
+ *              growing the set many times, while READERS threads look up
+ *              the kept keys over and over.  The hash function yields the
+ *              processor on every eighth key, and the comparison function
+ *              on one call in 32, so that threads are often switched in
+ *              the middle of moving elements to a larger table or of
+ *              inserting a key.  The number of lookups that missed is printed, and
+ *              the program fails if any did or if the final count is
+ *              wrong, as it would be if two writers both inserted the
+ *              same key.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdatomic.h>
+# include <pthread.h>
+# include <sched.h>
+# include <stdbool.h>
+# include "set.h"
+
+
+# define KEPT    1000		/* keys inserted before the threads start */
+# define ADDED   100000		/* keys inserted by each writer */
+# define WRITERS 2		/* threads inserting the added keys */
+# define READERS 2		/* threads looking up the kept keys */
+
+
+static SET *keys;
+static char *kept[KEPT];
+static atomic_int writing = WRITERS;
+static atomic_long misses;
+
+
+/*
+ * Function:    strhash
+ *
+ * Description: Return a hash value for a string S, yielding the processor
+ *		first for one string in eight.
+ */
+
+static unsigned strhash(char *s)
+{
+    unsigned hash = 0;
+
+
+    while (*s != '\0')
+        hash = 31 * hash + *s ++;
+
+    if (hash % 8 == 0)
+	sched_yield();
+
+    return hash;
+}
+
+
+/*
+ * Function:    strcompare
+ *
+ * Description: Compare the strings S and T, yielding the processor first
+ *		for one call in 32.
+ */
+
+static int strcompare(char *s, char *t)
+{
+    static atomic_uint calls;
+
+
+    if (atomic_fetch_add(&calls, 1) % 32 == 0)
+	sched_yield();
+
+    return strcmp(s, t);
+}
+
+
+/*
+ * Function:    makeKey
+ *
+ * Description: Return a newly allocated key for the number N.
+ */
+
+static char *makeKey(const char *prefix, int n)
+{
+    char buffer[32], *key;
+
+
+    sprintf(buffer, "%s%d", prefix, n);
+
+    if ((key = strdup(buffer)) == NULL) {
+	fprintf(stderr, "stress: out of memory\n");
+	exit(EXIT_FAILURE);
+    }
+
+    return key;
+}
+
+
+/*
+ * Function:    writer
+ *
+ * Description: Thread function that inserts ADDED new keys into the set,
+ *		freeing its copy of each key another writer stored first.
+ */
+
+static void *writer(void *arg)
+{
+    char *key;
+    bool found;
+    int i;
+
+
+    for (i = 0; i < ADDED; i ++) {
+	key = makeKey("added", i);
+	upsertElement(keys, key, &found);
+
+	if (found)
+	    free(key);
+    }
+
+    atomic_fetch_sub(&writing, 1);
+    return NULL;
+}
+
+
+/*
+ * Function:    reader
+ *
+ * Description: Thread function that looks up the kept keys, using copies
+ *		so that only an equal element can match, until the writers
+ *		are done.
+ */
+
+static void *reader(void *arg)
+{
+    char buffer[32];
+    int i;
+
+
+    while (atomic_load(&writing) > 0)
+	for (i = 0; i < KEPT; i ++) {
+	    sprintf(buffer, "kept%d", i);
+
+	    if (findElement(keys, buffer) != kept[i])
+		atomic_fetch_add(&misses, 1);
+	}
+
+    return NULL;
+}
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the test application.
+ */
+
+int main(void)
+{
+    pthread_t threads[WRITERS + READERS];
+    char *key;
+    int i, count;
+
+
+    keys = createSet(16, strcompare, strhash);
+
+    for (i = 0; i < KEPT; i ++) {
+	kept[i] = makeKey("kept", i);
+	addElement(keys, kept[i]);
+    }
+
+    for (i = 0; i < WRITERS; i ++)
+	pthread_create(&threads[i], NULL, writer, NULL);
+
+    for (i = WRITERS; i < WRITERS + READERS; i ++)
+	pthread_create(&threads[i], NULL, reader, NULL);
+
+    for (i = 0; i < WRITERS + READERS; i ++)
+	pthread_join(threads[i], NULL);
+
+    count = numElements(keys);
+    printf("%ld lookups missed\n", atomic_load(&misses));
+    printf("%d elements, expected %d\n", count, KEPT + ADDED);
+
+    for (key = firstElement(keys); key != NULL; key = nextElement(keys))
+	free(key);
+
+    destroySet(keys);
+
+    if (atomic_load(&misses) != 0 || count != KEPT + ADDED)
+	exit(EXIT_FAILURE);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,423 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 10/19/2025
+ *
+ * swiss.c
+ * Implementation of a generic hash table using the "Swiss table" layout.
+ * Alongside the array of elements is an array of one-byte control values:
+ * an Empty or Deleted marker, or the low 7 bits of the element's hash for a
+ * Filled slot. Slots are probed in aligned groups of 16, and one SSE2
+ * compare checks the control bytes of a whole group at once, so the
+ * user-provided compare function only runs on slots whose 7 hash bits
+ * already match.
+ *
+ * The table is rebuilt into one twice as large once it is seven eighths
+ * full (counting Deleted slots), or into one of the same size if most of
+ * the used slots are Deleted.
+ *
+ * Big O Time Complexities:
+ * createSet: O(m) - where m is maxElts
+ * destroySet: O(1)
+ * numElements: O(1)
+ * addElement: O(1) amortized average, O(m) worst case
+ * upsertElement: O(1) amortized average, O(m) worst case
+ * toggleElement: O(1) amortized average, O(m) worst case
+ * removeElement: O(1) average, O(m) worst case
+ * findElement: O(1) average, O(m) worst case
+ * findElements: O(n) average, O(nm) worst case - where n is the batch size
+ * getElements: O(m)
+ * firstElement: O(m) worst case
+ * nextElement: O(m) worst case, O(m) for a whole iteration
+ * search: O(1) average, O(m) worst case
+ * rehash: O(m)
+ * insert: O(1) amortized average, O(m) worst case
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "set.h"
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define GROUP 16
+#define EMPTY ((signed char) -128)
+#define DELETED ((signed char) -2)
+#define BATCH 16	/* keys hashed and prefetched together by findElements */
+
+typedef struct set {
+	size_t count;
+	size_t deleted;
+	size_t length;		/* number of slots, a power of two >= GROUP */
+	void **data;
+	signed char *ctrl;	/* Empty, Deleted, or 7 bits of the hash */
+	size_t cursor;		/* next slot to visit while iterating */
+	int (*compare)();
+	unsigned (*hash)();
+} SET;
+
+static int search(SET *sp, void *elt, unsigned hash, bool *found);
+
+/* private helper: scramble the user-provided hash so that both the 7 bits
+ * kept in the control byte and the bits used to pick a group are well
+ * distributed.
+ * Big O: O(1)
+ */
+static unsigned mix(unsigned hash) {
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+/* private helper: return a bit mask with bit i set if ctrl[i] == c for the
+ * GROUP control bytes starting at ctrl.
+ * Big O: O(1)
+ */
+static unsigned match(signed char *ctrl, signed char c) {
+#ifdef __SSE2__
+	__m128i group = _mm_load_si128((__m128i *) ctrl);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+	unsigned mask = 0;
+	for (int i = 0; i < GROUP; i++) {
+		if (ctrl[i] == c) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+#endif
+}
+
+/* private helper: return a bit mask of the Empty or Deleted slots in the
+ * group starting at ctrl. Both markers are negative and below -1, while the
+ * control byte of a Filled slot is never negative.
+ * Big O: O(1)
+ */
+static unsigned matchFree(signed char *ctrl) {
+#ifdef __SSE2__
+	__m128i group = _mm_load_si128((__m128i *) ctrl);
+	return _mm_movemask_epi8(_mm_cmplt_epi8(group, _mm_set1_epi8(-1)));
+#else
+	unsigned mask = 0;
+	for (int i = 0; i < GROUP; i++) {
+		if (ctrl[i] < -1) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+#endif
+}
+
+/* private helper: allocate the element and control arrays for length slots
+ * and mark every slot Empty.
+ * Big O: O(m)
+ */
+static void initTable(SET *sp, size_t length) {
+	sp->length = length;
+	sp->deleted = 0;
+	sp->data = malloc(sizeof(void*) * length);
+	assert(sp->data != NULL);
+	sp->ctrl = aligned_alloc(GROUP, length);
+	assert(sp->ctrl != NULL);
+	memset(sp->ctrl, EMPTY, length);
+}
+
+/* private helper: store elt in the first Empty or Deleted slot along its
+ * probe sequence and return that slot. The caller guarantees elt is not
+ * already present.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static size_t place(SET *sp, void *elt, unsigned hash) {
+	size_t mask = sp->length / GROUP - 1;
+	size_t g = (hash >> 7) & mask;
+	unsigned bits;
+	for (size_t i = 1; (bits = matchFree(sp->ctrl + g * GROUP)) == 0; i++) {
+		g = (g + i) & mask;
+	}
+	size_t locn = g * GROUP + __builtin_ctz(bits);
+	if (sp->ctrl[locn] == DELETED) {
+		sp->deleted--;
+	}
+	sp->data[locn] = elt;
+	sp->ctrl[locn] = hash & 0x7f;
+	return locn;
+}
+
+/* private helper: rebuild the table with room for the current elements
+ * and drop all Deleted slots.
+ * Big O: O(m)
+ */
+static void rehash(SET *sp) {
+	size_t oldLength = sp->length;
+	void **oldData = sp->data;
+	signed char *oldCtrl = sp->ctrl;
+	size_t length = oldLength;
+	if ((sp->count + 1) * 16 > oldLength * 7) {
+		length *= 2;
+	}
+	initTable(sp, length);
+	for (size_t i = 0; i < oldLength; i++) {
+		if (oldCtrl[i] >= 0) {
+			place(sp, oldData[i], mix((*sp->hash)(oldData[i])));
+		}
+	}
+	free(oldData);
+	free(oldCtrl);
+}
+
+/* createSet: allocate and initialize a new Swiss table SET with room for at
+ * least maxElts elements before it has to grow. Stores function pointers
+ * for comparison and hashing.
+ * Big O: O(m)
+ */
+SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()) {
+	SET *sp;
+	size_t length = GROUP;
+	assert(maxElts > 0);
+	assert(compare != NULL && hash != NULL);
+	sp = malloc(sizeof(SET));
+	assert(sp != NULL);
+	while (length * 7 / 8 < maxElts) {
+		length *= 2;
+	}
+	sp->count = 0;
+	sp->cursor = 0;
+	sp->compare = compare;
+	sp->hash = hash;
+	initTable(sp, length);
+	return sp;
+}
+
+/* destroySet: free the element and control arrays, and the set structure.
+ * Does NOT free individual elements as the caller retains ownership of the data.
+ * Big O: O(1)
+ */
+void destroySet(SET *sp) {
+	assert(sp != NULL);
+	free(sp->data);
+	free(sp->ctrl);
+	free(sp);
+}
+
+/* numElements: return the number of elements stored
+ * Big O: O(1)
+ */
+int numElements(SET *sp) {
+	assert(sp != NULL);
+	return sp->count;
+}
+
+/* addElement: insert elt in the table if no equal element is present.
+ * Stores the pointer directly without copying.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void addElement(SET *sp, void *elt) {
+	bool found;
+	upsertElement(sp, elt, &found);
+}
+
+/* private helper: add elt, which is known to be absent, at the slot idx
+ * found by search, and return the address of the slot it ends up in. The
+ * table is rebuilt first if it would become more than seven eighths full.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+static void **insert(SET *sp, void *elt, unsigned hash, int idx) {
+	if ((sp->count + sp->deleted + 1) * 8 > sp->length * 7) {
+		rehash(sp);
+		sp->count++;
+		return &sp->data[place(sp, elt, hash)];
+	}
+	if (sp->ctrl[idx] == DELETED) {
+		sp->deleted--;
+	}
+	sp->data[idx] = elt;
+	sp->ctrl[idx] = hash & 0x7f;
+	sp->count++;
+	return &sp->data[idx];
+}
+
+/* upsertElement: find or insert elt with a single hash and probe. If an
+ * equal element is present, *found is set to true and the address of its
+ * slot is returned. Otherwise elt itself is inserted, *found is set to
+ * false, and the address of the new slot is returned so the caller can
+ * replace elt with an equal element it owns before the next operation on
+ * the set.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void **upsertElement(SET *sp, void *elt, bool *found) {
+	assert((elt != NULL) && (sp != NULL) && (found != NULL));
+	unsigned hash = mix((*sp->hash)(elt));
+	int idx = search(sp, elt, hash, found);
+	if (*found) {
+		return &sp->data[idx];
+	}
+	return insert(sp, elt, hash, idx);
+}
+
+/* toggleElement: insert elt if no equal element is present, or remove the
+ * equal element if there is one, using a single hash and probe. On removal
+ * the removed element is stored in *removed and NULL is returned, so the
+ * caller can free it. On insertion the address of the new slot is
+ * returned, so the caller can replace elt with an equal element it owns
+ * before the next operation on the set, as with upsertElement.
+ * Big O: O(1) amortized average case, O(m) worst case
+ */
+void **toggleElement(SET *sp, void *elt, void **removed) {
+	assert((elt != NULL) && (sp != NULL) && (removed != NULL));
+	bool found;
+	unsigned hash = mix((*sp->hash)(elt));
+	int idx = search(sp, elt, hash, &found);
+	if (found) {
+		*removed = sp->data[idx];
+		sp->ctrl[idx] = DELETED;
+		sp->deleted++;
+		sp->count--;
+		return NULL;
+	}
+	return insert(sp, elt, hash, idx);
+}
+
+/* removeElement: remove elt from the table if present by marking its slot
+ * Deleted. Does NOT free the element as caller owns the data.
+ * Big O: O(1) average case, O(m) worst case
+ */
+void removeElement(SET *sp, void *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int idx = search(sp, elt, mix((*sp->hash)(elt)), &found);
+	if (found) {
+		sp->ctrl[idx] = DELETED;
+		sp->deleted++;
+		sp->count--;
+	}
+}
+
+/* findElement: return pointer to stored element equal to elt, or NULL if
+ * not found.
+ * Big O: O(1) average case, O(m) worst case
+ */
+void *findElement(SET *sp, void *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	int idx = search(sp, elt, mix((*sp->hash)(elt)), &found);
+	return found ? sp->data[idx] : NULL;
+}
+
+/* findElements: look up the n elements of elts and store the match for
+ * each (or NULL) in the same position of matches. Keys are handled BATCH
+ * at a time: all of them are hashed and the control bytes and elements of
+ * their first groups prefetched before any probing starts.
+ * Big O: O(n) average case, O(nm) worst case - where n is the batch size
+ */
+void findElements(SET *sp, void **elts, int n, void **matches) {
+	assert((sp != NULL) && (elts != NULL) && (matches != NULL));
+	unsigned hashes[BATCH];
+	size_t mask = sp->length / GROUP - 1;
+	int i, j, m, idx;
+	bool found;
+	for (i = 0; i < n; i += BATCH) {
+		m = n - i < BATCH ? n - i : BATCH;
+		for (j = 0; j < m; j++) {
+			assert(elts[i + j] != NULL);
+			hashes[j] = mix((*sp->hash)(elts[i + j]));
+			size_t g = (hashes[j] >> 7) & mask;
+			__builtin_prefetch(sp->ctrl + g * GROUP);
+			__builtin_prefetch(sp->data + g * GROUP);
+			__builtin_prefetch(sp->data + g * GROUP + GROUP / 2);
+		}
+		for (j = 0; j < m; j++) {
+			idx = search(sp, elts[i + j], hashes[j], &found);
+			matches[i + j] = found ? sp->data[idx] : NULL;
+		}
+	}
+}
+
+/* getElements: return a newly-allocated array of generic pointers to the
+ * elements stored in the table.
+ * Big O: O(m)
+ */
+void *getElements(SET *sp) {
+	assert(sp != NULL);
+	void **cpy;
+	cpy = malloc(sp->count*sizeof(void *));
+	assert(cpy != NULL);
+	int j = 0;
+	for (size_t i = 0; i < sp->length; i++) {
+		if (sp->ctrl[i] >= 0) {
+			cpy[j] = sp->data[i];
+			j++;
+		}
+	}
+	return cpy;
+}
+
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The elements are
+ * visited in place without allocating. The set must not be changed until
+ * nextElement returns NULL.
+ * Big O: O(m) worst case
+ */
+void *firstElement(SET *sp) {
+	assert(sp != NULL);
+	sp->cursor = 0;
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned.
+ * Big O: O(m) worst case, O(m) for a whole iteration
+ */
+void *nextElement(SET *sp) {
+	assert(sp != NULL);
+	while (sp->cursor < sp->length) {
+		size_t i = sp->cursor++;
+		if (sp->ctrl[i] >= 0) {
+			return sp->data[i];
+		}
+	}
+	return NULL;
+}
+
+
+/* private helper: returns the index of element in the table or the index
+ * where you would insert it. Groups are visited in triangular order, which
+ * covers every group because the number of groups is a power of two. In
+ * each group only slots whose control byte equals the 7 hash bits are
+ * compared, and the search stops at the first group with an Empty slot.
+ * Returns the first Empty or Deleted slot seen if element is not found.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static int search(SET *sp, void *elt, unsigned hash, bool *found) {
+	size_t mask = sp->length / GROUP - 1;
+	size_t g = (hash >> 7) & mask;
+	signed char h2 = hash & 0x7f;
+	int available = -1;
+	unsigned bits;
+
+	for (size_t i = 1; i <= mask + 1; i++) {
+		signed char *ctrl = sp->ctrl + g * GROUP;
+		for (bits = match(ctrl, h2); bits != 0; bits &= bits - 1) {
+			size_t locn = g * GROUP + __builtin_ctz(bits);
+			if ((*sp->compare)(sp->data[locn], elt) == 0) {
+				*found = true;
+				return locn;
+			}
+		}
+		if (available == -1 && (bits = matchFree(ctrl)) != 0) {
+			available = g * GROUP + __builtin_ctz(bits);
+		}
+		if (match(ctrl, EMPTY) != 0) {
+			break;
+		}
+		g = (g + i) & mask;
+	}
+	*found = false;
+	return available;
+}
@@ -4,20 +4,36 @@
  * 10/19/2025
  *
  * table.c
- * Implementation of a generic hash table for arbitrary data types using 
- * open addressing with linear probing. Elements are stored in an array 
+ * Implementation of a generic hash table for arbitrary data types using
+ * open addressing with linear probing. Elements are stored in an array
  * with flags indicating Empty, Filled, or Deleted states. Uses function
  * pointers for comparison and hashing to support any data type.
  *
+ * The table grows once it is three quarters full (counting Deleted slots).
+ * Instead of rebuilding all at once, the old table is kept alongside the
+ * new one and drained a few slots at a time by each later operation, so
+ * no single call pays for the whole rehash.
+ *
  * Big O Time Complexities:
  * createSet: O(m) - where m is maxElts
- * destroySet: O(1) 
+ * destroySet: O(1)
  * numElements: O(1)
  * addElement: O(1) average, O(m) worst case
+ * upsertElement: O(1) average, O(m) worst case
+ * toggleElement: O(1) average, O(m) worst case
  * removeElement: O(1) average, O(m) worst case
  * findElement: O(1) average, O(m) worst case
- * getElements: O(m) 
+ * findElements: O(n) average, O(nm) worst case - where n is the batch size
+ * getElements: O(m)
+ * firstElement: O(m) worst case
+ * nextElement: O(m) worst case, O(m) for a whole iteration
  * search: O(1) average, O(m) worst case
+ * locate: O(1) average, O(m) worst case
+ * lookup: O(1) average, O(m) worst case
+ * insert: O(1) average, O(m) worst case
+ * rehashStep: O(1)
+ * grow: O(m) to allocate the new table
+ * getSetStats: O(m), only with SET_STATS
  */
 
 #include <stdlib.h>
@@ -31,20 +47,154 @@
 #define FILLED 'F'
 #define DELETED 'D'
 
-typedef struct set {
-	size_t count;
+#define REHASH_STEP 8	/* old slots migrated per operation while growing */
+#define BATCH 16	/* keys hashed and prefetched together by findElements */
+
+struct table {
 	size_t length;
+	size_t deleted;
 	void **data;
-    char *flags;
+	char *flags;
+};
+
+typedef struct set {
+	size_t count;
+	struct table cur;	/* table receiving all new insertions */
+	struct table old;	/* table being drained, length 0 if none */
+	size_t next;		/* next slot of old to migrate */
+	size_t cursor;		/* next slot of cur to visit while iterating */
     int (*compare)();
     unsigned (*hash)();
+#ifdef SET_STATS
+	struct setstats stats;
+#endif
 } SET;
 
-static int search(SET *sp, void *elt, bool *found);
+static int search(SET *sp, struct table *tp, void *elt, unsigned hash, bool *found, size_t *probes);
+static void rehashStep(SET *sp);
+
+#ifdef SET_STATS
+/* private helper: count an operation that examined probes slots after the
+ * home slot, over both tables while growing, in the histogram hist.
+ * Big O: O(1)
+ */
+static void countProbe(SET *sp, unsigned long *hist, size_t probes) {
+	hist[probes < STATS_BUCKETS - 1 ? probes : STATS_BUCKETS - 1]++;
+	if (probes > sp->stats.maxProbe) {
+		sp->stats.maxProbe = probes;
+	}
+}
+
+/* private helper: print the statistics of the set to stderr.
+ * Big O: O(m)
+ */
+static void dumpStats(SET *sp) {
+	struct setstats st;
+	int i;
+	getSetStats(sp, &st);
+	fprintf(stderr, "set: %zu live, %zu tombstones, %zu empty, %zu rehashes\n",
+		st.live, st.tombstones, st.empty, st.rehashes);
+	fprintf(stderr, "set: %zu slot bytes, %zu key bytes, longest probe %zu\n",
+		st.slotBytes, st.keyBytes, st.maxProbe);
+	fprintf(stderr, "set: hits by probe length:");
+	for (i = 0; i < STATS_BUCKETS; i++) {
+		fprintf(stderr, " %lu", st.hits[i]);
+	}
+	fprintf(stderr, "\nset: misses by probe length:");
+	for (i = 0; i < STATS_BUCKETS; i++) {
+		fprintf(stderr, " %lu", st.misses[i]);
+	}
+	fprintf(stderr, "\n");
+}
+
+#define COUNT_SEARCH(sp, found, probes) \
+	countProbe(sp, (found) ? (sp)->stats.hits : (sp)->stats.misses, probes)
+#define COUNT_REHASH(sp) ((sp)->stats.rehashes++)
+#else
+#define COUNT_SEARCH(sp, found, probes)
+#define COUNT_REHASH(sp)
+#endif
+
+/* private helper: allocate the arrays of tp with length slots, all Empty.
+ * Big O: O(m)
+ */
+static void initTable(struct table *tp, size_t length) {
+	tp->length = length;
+	tp->deleted = 0;
+	tp->data = malloc(sizeof(void*) * length);
+	assert(tp->data != NULL);
+	tp->flags = malloc(sizeof(char) * length);
+	assert(tp->flags != NULL);
+	memset(tp->flags, EMPTY, length);
+}
+
+/* private helper: store elt in the first non-Filled slot of its probe
+ * sequence in tp and return that slot. The caller guarantees elt is not
+ * already present.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static size_t place(struct table *tp, void *elt, unsigned hash) {
+	size_t locn = hash % tp->length;
+	while (tp->flags[locn] == FILLED) {
+		locn = (locn + 1) % tp->length;
+	}
+	if (tp->flags[locn] == DELETED) {
+		tp->deleted--;
+	}
+	tp->data[locn] = elt;
+	tp->flags[locn] = FILLED;
+	return locn;
+}
+
+/* private helper: start a new table and leave the current one to be
+ * drained by rehashStep. The new table doubles in size unless most of the
+ * used slots are Deleted, in which case the same size is enough.
+ * Big O: O(m)
+ */
+static void grow(SET *sp) {
+	size_t length;
+	while (sp->old.length != 0) {
+		rehashStep(sp);
+	}
+	COUNT_REHASH(sp);
+	length = sp->cur.length;
+	if (sp->count * 4 >= length) {
+		length *= 2;
+	}
+	sp->old = sp->cur;
+	sp->next = 0;
+	initTable(&sp->cur, length);
+}
 
-/* createSet: allocate and initialize a new generic hash table SET holding up to
- * maxElts elements. Stores function pointers for comparison and hashing.
- * Initializes the data array and flags array.
+/* private helper: move up to REHASH_STEP slots of the old table into the
+ * current one, and release the old table once it has been fully drained.
+ * Migrated slots are marked Deleted so later searches of the old table
+ * neither find a stale copy nor stop early.
+ * Big O: O(1)
+ */
+static void rehashStep(SET *sp) {
+	int i;
+	if (sp->old.length == 0) {
+		return;
+	}
+	for (i = 0; i < REHASH_STEP && sp->next < sp->old.length; i++) {
+		if (sp->old.flags[sp->next] == FILLED) {
+			void *elt = sp->old.data[sp->next];
+			place(&sp->cur, elt, (*sp->hash)(elt));
+			sp->old.flags[sp->next] = DELETED;
+		}
+		sp->next++;
+	}
+	if (sp->next == sp->old.length) {
+		free(sp->old.data);
+		free(sp->old.flags);
+		sp->old.length = 0;
+	}
+}
+
+/* createSet: allocate and initialize a new generic hash table SET with an
+ * initial capacity of maxElts elements. Stores function pointers for
+ * comparison and hashing. Initializes the data array and flags array.
  * Big O: O(m)
  */
 SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()) {
@@ -53,16 +203,15 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()) {
 	assert(sp != NULL);
 	assert(maxElts > 0);
 	sp->count = 0;
-	sp->length = maxElts;
     sp->compare = compare;
     sp->hash = hash;
-	sp->data = malloc(sizeof(void*) * maxElts);
-	assert(sp->data != NULL);
-	sp->flags = malloc(sizeof(char) * maxElts);
-	assert(sp->flags != NULL);
-	for (int i = 0; i < maxElts; i++) {
-		sp->flags[i] = EMPTY;
-	}
+	initTable(&sp->cur, maxElts);
+	sp->old.length = 0;
+	sp->next = 0;
+	sp->cursor = 0;
+#ifdef SET_STATS
+	memset(&sp->stats, 0, sizeof(sp->stats));
+#endif
 	return sp;
 }
 
@@ -72,8 +221,17 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)()) {
  */
 void destroySet(SET *sp) {
 	assert(sp != NULL);
-	free(sp->data);
-	free(sp->flags);
+#ifdef SET_STATS
+	if (getenv("SET_STATS") != NULL) {
+		dumpStats(sp);
+	}
+#endif
+	if (sp->old.length != 0) {
+		free(sp->old.data);
+		free(sp->old.flags);
+	}
+	free(sp->cur.data);
+	free(sp->cur.flags);
 	free(sp);
 }
 
@@ -91,15 +249,97 @@ int numElements(SET *sp) {
  * Big O: O(1) average case, O(m) worst case
  */
 void addElement(SET *sp, void *elt) {
-	assert((elt != NULL) && (sp != NULL));	
 	bool found;
-	int idx = search(sp, elt, &found);
-	if (!found) {
-		assert(sp->count < sp->length);
-		sp->data[idx] = elt;
-		sp->flags[idx] = FILLED;
-		sp->count++;
+	upsertElement(sp, elt, &found);
+}
+
+/* private helper: search for elt, whose hash has already been computed,
+ * in the current table and then, while growing, in the old one. If it is
+ * found, *found is set to true, *tp to the table holding it, and its index
+ * is returned. Otherwise *tp is the current table and the index returned
+ * is where search would insert it there. The operation is counted once,
+ * with the probes of both searches, the old table's home slot included.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static int locate(SET *sp, void *elt, unsigned hash, struct table **tp, bool *found) {
+	size_t probes, more;
+	int idx = search(sp, &sp->cur, elt, hash, found, &probes);
+	*tp = &sp->cur;
+	if (!*found && sp->old.length != 0) {
+		int old = search(sp, &sp->old, elt, hash, found, &more);
+		probes += more + 1;
+		if (*found) {
+			*tp = &sp->old;
+			idx = old;
+		}
+	}
+	COUNT_SEARCH(sp, *found, probes);
+	return idx;
+}
+
+/* private helper: add elt, which is known to be absent, at the slot idx
+ * of the current table found by search, and return the address of the
+ * slot it ends up in. Grows the table first if it would become more than
+ * three quarters full, in which case elt is placed in the new table.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static void **insert(SET *sp, void *elt, unsigned hash, int idx) {
+	sp->count++;
+	if ((sp->count + sp->cur.deleted) * 4 > sp->cur.length * 3) {
+		grow(sp);
+		return &sp->cur.data[place(&sp->cur, elt, hash)];
+	}
+	if (sp->cur.flags[idx] == DELETED) {
+		sp->cur.deleted--;
+	}
+	sp->cur.data[idx] = elt;
+	sp->cur.flags[idx] = FILLED;
+	return &sp->cur.data[idx];
+}
+
+/* upsertElement: find or insert elt with a single hash and probe. If an
+ * equal element is present, *found is set to true and the address of its
+ * slot is returned. Otherwise elt itself is inserted, *found is set to
+ * false, and the address of the new slot is returned so the caller can
+ * replace elt with an equal element it owns (such as a copy) before the
+ * next operation on the set.
+ * Big O: O(1) average case, O(m) worst case
+ */
+void **upsertElement(SET *sp, void *elt, bool *found) {
+	assert((elt != NULL) && (sp != NULL) && (found != NULL));
+	struct table *tp;
+	rehashStep(sp);
+	unsigned hash = (*sp->hash)(elt);
+	int idx = locate(sp, elt, hash, &tp, found);
+	if (*found) {
+		return &tp->data[idx];
+	}
+	return insert(sp, elt, hash, idx);
+}
+
+/* toggleElement: insert elt if no equal element is present, or remove the
+ * equal element if there is one, using a single hash and probe. On removal
+ * the removed element is stored in *removed and NULL is returned, so the
+ * caller can free it. On insertion the address of the new slot is
+ * returned, so the caller can replace elt with an equal element it owns
+ * before the next operation on the set, as with upsertElement.
+ * Big O: O(1) average case, O(m) worst case
+ */
+void **toggleElement(SET *sp, void *elt, void **removed) {
+	assert((elt != NULL) && (sp != NULL) && (removed != NULL));
+	bool found;
+	struct table *tp;
+	rehashStep(sp);
+	unsigned hash = (*sp->hash)(elt);
+	int idx = locate(sp, elt, hash, &tp, &found);
+	if (found) {
+		*removed = tp->data[idx];
+		tp->flags[idx] = DELETED;
+		tp->deleted++;
+		sp->count--;
+		return NULL;
 	}
+	return insert(sp, elt, hash, idx);
 }
 
 /* removeElement: remove elt from the hash table if present by marking
@@ -110,30 +350,69 @@ void addElement(SET *sp, void *elt) {
 void removeElement(SET *sp, void *elt) {
 	assert((sp != NULL) && (elt != NULL));
 	bool found;
-	int idx = search(sp, elt, &found);
+	struct table *tp;
+	rehashStep(sp);
+	unsigned hash = (*sp->hash)(elt);
+	int idx = locate(sp, elt, hash, &tp, &found);
 	if (found) {
-		sp->flags[idx] = DELETED;
+		tp->flags[idx] = DELETED;
+		tp->deleted++;
 		sp->count--;
 	}
 }
 
+/* private helper: return the stored element equal to elt, whose hash has
+ * already been computed, from either table, or NULL if not found.
+ * Big O: O(1) average case, O(m) worst case
+ */
+static void *lookup(SET *sp, void *elt, unsigned hash) {
+	bool found;
+	struct table *tp;
+	int idx = locate(sp, elt, hash, &tp, &found);
+	return found ? tp->data[idx] : NULL;
+}
+
 /* findElement: return pointer to stored element equal to elt using hash table
  * lookup with user-provided hash and compare functions, or NULL if not found.
  * Big O: O(1) average case, O(m) worst case
  */
 void *findElement(SET *sp, void *elt) {
 	assert((sp != NULL) && (elt != NULL));
-	bool found;
-	int idx = search(sp, elt, &found);
-	if (!found) {
-		return NULL;
+	rehashStep(sp);
+	return lookup(sp, elt, (*sp->hash)(elt));
+}
+
+/* findElements: look up the n elements of elts and store the match for
+ * each (or NULL) in the same position of matches. Keys are handled BATCH
+ * at a time: all of them are hashed and their home slots prefetched
+ * before any probing starts, so the cache misses of a batch overlap
+ * instead of being taken one after another.
+ * Big O: O(n) average case, O(nm) worst case - where n is the batch size
+ */
+void findElements(SET *sp, void **elts, int n, void **matches) {
+	assert((sp != NULL) && (elts != NULL) && (matches != NULL));
+	unsigned hashes[BATCH];
+	int i, j, m;
+	for (i = 0; i < n; i += BATCH) {
+		m = n - i < BATCH ? n - i : BATCH;
+		rehashStep(sp);
+		for (j = 0; j < m; j++) {
+			assert(elts[i + j] != NULL);
+			hashes[j] = (*sp->hash)(elts[i + j]);
+			size_t locn = hashes[j] % sp->cur.length;
+			__builtin_prefetch(&sp->cur.flags[locn]);
+			__builtin_prefetch(&sp->cur.data[locn]);
+		}
+		for (j = 0; j < m; j++) {
+			matches[i + j] = lookup(sp, elts[i + j], hashes[j]);
+		}
 	}
-	return sp->data[idx];
 }
 
-/* getElements: return a newly-allocated array of generic pointers to the 
- * elements stored in the hash table (only Filled slots).
- * Big O: O(m) - where m is maxElts
+/* getElements: return a newly-allocated array of generic pointers to the
+ * elements stored in the hash table (only Filled slots), including any
+ * that have not yet been migrated out of the old table.
+ * Big O: O(m) - where m is the current table length
  */
 void *getElements(SET *sp) {
 	assert(sp != NULL);
@@ -141,53 +420,121 @@ void *getElements(SET *sp) {
 	cpy = malloc(sp->count*sizeof(void *));
 	assert(cpy != NULL);
 	int j = 0;
-	for (int i = 0; i < sp->length; i++) {
-		if (sp->flags[i] == FILLED) {
-			cpy[j] = sp->data[i];
+	for (int i = 0; i < sp->cur.length; i++) {
+		if (sp->cur.flags[i] == FILLED) {
+			cpy[j] = sp->cur.data[i];
+			j++;
+		}
+	}
+	for (int i = sp->next; i < sp->old.length; i++) {
+		if (sp->old.flags[i] == FILLED) {
+			cpy[j] = sp->old.data[i];
 			j++;
 		}
 	}
 	return cpy;
 }
 
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. Any growth still under
+ * way is finished first, so that the elements are all in the current table
+ * and are visited there in place without allocating. The set must not be
+ * changed until nextElement returns NULL.
+ * Big O: O(m) worst case
+ */
+void *firstElement(SET *sp) {
+	assert(sp != NULL);
+	while (sp->old.length != 0) {
+		rehashStep(sp);
+	}
+	sp->cursor = 0;
+	return nextElement(sp);
+}
 
-/* private helper: returns the index of element in hash table or the index
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned.
+ * Big O: O(m) worst case, O(m) for a whole iteration
+ */
+void *nextElement(SET *sp) {
+	assert(sp != NULL);
+	while (sp->cursor < sp->cur.length) {
+		size_t i = sp->cursor++;
+		if (sp->cur.flags[i] == FILLED) {
+			return sp->cur.data[i];
+		}
+	}
+	return NULL;
+}
+
+#ifdef SET_STATS
+/* getSetStats: store the statistics of the set in *stats. While the table
+ * is growing, the slot counts and bytes cover both the old and new tables.
+ * Big O: O(m)
+ */
+void getSetStats(SET *sp, struct setstats *stats) {
+	assert((sp != NULL) && (stats != NULL));
+	struct table *tables[2] = { &sp->cur, &sp->old };
+	*stats = sp->stats;
+	for (int t = 0; t < 2; t++) {
+		for (size_t i = 0; i < tables[t]->length; i++) {
+			if (tables[t]->flags[i] == FILLED) {
+				stats->live++;
+			}
+			else if (tables[t]->flags[i] == DELETED) {
+				stats->tombstones++;
+			}
+			else {
+				stats->empty++;
+			}
+		}
+		stats->slotBytes += tables[t]->length * (sizeof(void *) + sizeof(char));
+	}
+}
+#endif
+
+
+/* private helper: returns the index of element in table tp or the index
  * where you would insert it, found using linear probing from the hash value.
- * Uses the user-provided hash function to compute initial index and the
- * compare function to check for equality. Returns the first Deleted slot 
- * encountered if element is not found.
+ * The hash is computed once by the caller with the user-provided hash
+ * function so it can be shared between the current and old tables, and the
+ * compare function is used to check for equality. Returns the first Deleted
+ * slot encountered if element is not found. The number of slots examined
+ * after the home slot is stored in *probes.
  * Big O: O(1) average case, O(m) worst case
  */
-static int search(SET *sp, void *elt, bool *found) {
+static int search(SET *sp, struct table *tp, void *elt, unsigned hash, bool *found, size_t *probes) {
 	assert(sp != NULL);
 
-	int idx = (*sp->hash)(elt) % sp->length;
+	int idx = hash % tp->length;
 	int i = 0;
 	int firstDeleted = -1;
 	int locn;
-	
-	while (i < sp->length) {
-		locn = (idx + i ) % sp->length;
-		if (sp->flags[locn] == DELETED) {
+
+	while (i < tp->length) {
+		locn = (idx + i ) % tp->length;
+		if (tp->flags[locn] == DELETED) {
 			if (firstDeleted == -1) {
 				firstDeleted = locn;
 			}
 		}
-		else if (sp->flags[locn] == EMPTY) {
+		else if (tp->flags[locn] == EMPTY) {
+			*probes = i;
 			*found = false;
 			if (firstDeleted == -1) {
 				return locn;
 			}
 			return firstDeleted;
 		}
-		else if (sp->flags[locn] == FILLED) {
-			if ((*sp->compare)(sp->data[locn], elt) == 0) {
+		else if (tp->flags[locn] == FILLED) {
+			if ((*sp->compare)(tp->data[locn], elt) == 0) {
+				*probes = i;
 				*found = true;
 				return locn;
 			}
 		}
 		i++;
 	}
-	*found = false; 
+	*probes = i;
+	*found = false;
 	return firstDeleted;
 }
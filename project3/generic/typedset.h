@@ -0,0 +1,189 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 10/19/2025
+ *
+ * typedset.h
+ * Generator for hash table sets specialized to one key type. Writing
+ *
+ *     DEFINE_SET(name, key_type, hash_fn, eq_fn)
+ *
+ * at file scope defines the type name and the static functions below, with
+ * the same semantics as the generic SET in table.c: open addressing with
+ * linear probing, Empty/Filled/Deleted flags, and growth once the table is
+ * three quarters full. Keys are stored by value and compared with
+ * eq_fn(a, b), which returns nonzero if a and b are equal, and hashed with
+ * hash_fn(k), which returns an unsigned. Since both are called directly
+ * rather than through function pointers, the compiler can inline them into
+ * the probe loop. The table is rebuilt all at once when it grows.
+ *
+ * Generated functions:
+ * name *name_create(int maxElts): O(m)
+ * void name_destroy(name *sp): O(1)
+ * int name_count(name *sp): O(1)
+ * key_type *name_find(name *sp, key_type elt): O(1) average, O(m) worst case
+ * key_type *name_upsert(name *sp, key_type elt, bool *found): O(1) average
+ * bool name_add(name *sp, key_type elt): O(1) average, O(m) worst case
+ * bool name_remove(name *sp, key_type elt): O(1) average, O(m) worst case
+ * key_type *name_elements(name *sp): O(m)
+ *
+ * The generic set.h interface remains the fallback for code that chooses
+ * its compare and hash functions at run time.
+ */
+
+#ifndef TYPEDSET_H
+#define TYPEDSET_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#define TYPEDSET_EMPTY 'E'
+#define TYPEDSET_FILLED 'F'
+#define TYPEDSET_DELETED 'D'
+
+#define DEFINE_SET(name, key_type, hash_fn, eq_fn)			\
+									\
+typedef struct name {							\
+	size_t count;							\
+	size_t deleted;							\
+	size_t length;							\
+	key_type *data;							\
+	char *flags;							\
+} name;									\
+									\
+/* search: return the slot of elt, or the first Deleted or Empty slot	\
+ * where it would be inserted. */					\
+static inline size_t name##_search(name *sp, key_type elt, bool *found) { \
+	size_t locn = hash_fn(elt) % sp->length;			\
+	size_t available = sp->length;					\
+	for (size_t i = 0; i < sp->length; i++) {			\
+		if (sp->flags[locn] == TYPEDSET_EMPTY) {		\
+			*found = false;					\
+			return available != sp->length ? available : locn; \
+		}							\
+		else if (sp->flags[locn] == TYPEDSET_DELETED) {		\
+			if (available == sp->length) {			\
+				available = locn;			\
+			}						\
+		}							\
+		else if (eq_fn(sp->data[locn], elt)) {			\
+			*found = true;					\
+			return locn;					\
+		}							\
+		locn = locn + 1 == sp->length ? 0 : locn + 1;		\
+	}								\
+	*found = false;							\
+	return available;						\
+}									\
+									\
+static inline void name##_init(name *sp, size_t length) {		\
+	sp->length = length;						\
+	sp->deleted = 0;						\
+	sp->data = malloc(sizeof(key_type) * length);			\
+	assert(sp->data != NULL);					\
+	sp->flags = malloc(length);					\
+	assert(sp->flags != NULL);					\
+	memset(sp->flags, TYPEDSET_EMPTY, length);			\
+}									\
+									\
+static inline name *name##_create(int maxElts) {			\
+	name *sp;							\
+	assert(maxElts > 0);						\
+	sp = malloc(sizeof(name));					\
+	assert(sp != NULL);						\
+	sp->count = 0;							\
+	name##_init(sp, maxElts);					\
+	return sp;							\
+}									\
+									\
+static inline void name##_destroy(name *sp) {				\
+	assert(sp != NULL);						\
+	free(sp->data);							\
+	free(sp->flags);						\
+	free(sp);							\
+}									\
+									\
+static inline int name##_count(name *sp) {				\
+	assert(sp != NULL);						\
+	return sp->count;						\
+}									\
+									\
+/* grow: rebuild the table, doubling it unless most used slots are	\
+ * Deleted, and drop all Deleted slots. */				\
+static inline void name##_grow(name *sp) {				\
+	key_type *data = sp->data;					\
+	char *flags = sp->flags;					\
+	size_t length = sp->length;					\
+	bool found;							\
+	name##_init(sp, sp->count * 4 >= length ? length * 2 : length);	\
+	for (size_t i = 0; i < length; i++) {				\
+		if (flags[i] == TYPEDSET_FILLED) {			\
+			size_t locn = name##_search(sp, data[i], &found); \
+			sp->data[locn] = data[i];			\
+			sp->flags[locn] = TYPEDSET_FILLED;		\
+		}							\
+	}								\
+	free(data);							\
+	free(flags);							\
+}									\
+									\
+static inline key_type *name##_find(name *sp, key_type elt) {		\
+	bool found;							\
+	assert(sp != NULL);						\
+	size_t locn = name##_search(sp, elt, &found);			\
+	return found ? &sp->data[locn] : NULL;				\
+}									\
+									\
+/* upsert: return the slot holding elt, inserting elt if it is absent.	\
+ * The slot may be overwritten with an equal key by the caller. */	\
+static inline key_type *name##_upsert(name *sp, key_type elt, bool *found) { \
+	assert(sp != NULL && found != NULL);				\
+	size_t locn = name##_search(sp, elt, found);			\
+	if (!*found) {							\
+		if ((sp->count + sp->deleted + 1) * 4 > sp->length * 3) { \
+			name##_grow(sp);				\
+			locn = name##_search(sp, elt, found);		\
+		}							\
+		if (sp->flags[locn] == TYPEDSET_DELETED) {		\
+			sp->deleted--;					\
+		}							\
+		sp->data[locn] = elt;					\
+		sp->flags[locn] = TYPEDSET_FILLED;			\
+		sp->count++;						\
+	}								\
+	return &sp->data[locn];						\
+}									\
+									\
+static inline bool name##_add(name *sp, key_type elt) {			\
+	bool found;							\
+	name##_upsert(sp, elt, &found);					\
+	return !found;							\
+}									\
+									\
+static inline bool name##_remove(name *sp, key_type elt) {		\
+	bool found;							\
+	assert(sp != NULL);						\
+	size_t locn = name##_search(sp, elt, &found);			\
+	if (found) {							\
+		sp->flags[locn] = TYPEDSET_DELETED;			\
+		sp->deleted++;						\
+		sp->count--;						\
+	}								\
+	return found;							\
+}									\
+									\
+static inline key_type *name##_elements(name *sp) {			\
+	assert(sp != NULL);						\
+	key_type *elts = malloc(sizeof(key_type) * (sp->count ? sp->count : 1)); \
+	assert(elts != NULL);						\
+	for (size_t i = 0, j = 0; i < sp->length; i++) {		\
+		if (sp->flags[i] == TYPEDSET_FILLED) {			\
+			elts[j++] = sp->data[i];			\
+		}							\
+	}								\
+	return elts;							\
+}
+
+#endif /* TYPEDSET_H */
@@ -0,0 +1,158 @@
+/*
+ * File:        typedunique.c
+ *
+ * Copyright:	2021, Darren C. Atkinson
+ *
+ * Description: This file contains the main function for testing a set
+ *              of strings generated by DEFINE_SET in typedset.h.
+ *
+ *              The program takes two files as command line arguments, the
+ *              second of which is optional.  All words in the first file
+ *              are inserted into the set and the counts of total words and
+ *              total words in the set are printed.  If the second file is
+ *              given then all words in the second file are deleted from
+ *              the set and the count printed.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include "typedset.h"
+
+
+/* This is sufficient for the test cases in /scratch/coen12. */
+
+# define MAX_SIZE 18000
+
+
+/*
+ * Function:    strhash
+ *
+ * Description: Return a hash value for a string S.
+ */
+
+static unsigned strhash(char *s)
+{
+    unsigned hash = 0;
+
+
+    while (*s != '\0')
+        hash = 31 * hash + *s ++;
+
+    return hash;
+}
+
+
+/*
+ * Function:    streq
+ *
+ * Description: Return whether the strings S and T are equal.
+ */
+
+static inline bool streq(char *s, char *t)
+{
+    return strcmp(s, t) == 0;
+}
+
+
+DEFINE_SET(WORDS, char *, strhash, streq)
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the test application.
+ */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    char buffer[BUFSIZ], **elts, **slot, *word;
+    WORDS *unique;
+    int i, words;
+    bool found, lflag = false;
+
+
+    /* Check usage and open the first file. */
+
+    if (argc > 1 && strcmp(argv[1], "-l") == 0) {
+	lflag = true;
+	argc --;
+
+	for (i = 1; i < argc; i ++)
+	    argv[i] = argv[i + 1];
+    }
+
+    if (argc == 1 || argc > 3) {
+        fprintf(stderr, "usage: %s [-l] file1 [file2]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((fp = fopen(argv[1], "r")) == NULL) {
+        fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+        exit(EXIT_FAILURE);
+    }
+
+
+    /* Insert all words into the set. */
+
+    words = 0;
+    unique = WORDS_create(MAX_SIZE);
+
+    while (fscanf(fp, "%s", buffer) == 1) {
+        words ++;
+	slot = WORDS_upsert(unique, buffer, &found);
+
+	if (!found)
+	    *slot = strdup(buffer);
+    }
+
+    fclose(fp);
+
+    if (!lflag) {
+	printf("%d total words\n", words);
+	printf("%d distinct words\n", WORDS_count(unique));
+    }
+
+
+    /* Try to open the second file. */
+
+    if (argc == 3) {
+        if ((fp = fopen(argv[2], "r")) == NULL) {
+            fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[2]);
+            exit(EXIT_FAILURE);
+        }
+
+
+        /* Delete all words in the second file. */
+
+        while (fscanf(fp, "%s", buffer) == 1) {
+	    if ((slot = WORDS_find(unique, buffer)) != NULL) {
+		word = *slot;
+		WORDS_remove(unique, buffer);
+		free(word);
+	    }
+	}
+
+	fclose(fp);
+
+	if (!lflag)
+	    printf("%d remaining words\n", WORDS_count(unique));
+    }
+
+
+    /* Print the list of words if desired. */
+
+    if (lflag) {
+	elts = WORDS_elements(unique);
+
+	for (i = 0; i < WORDS_count(unique); i ++)
+	    printf("%s\n", elts[i]);
+
+	free(elts);
+    }
+
+    WORDS_destroy(unique);
+    exit(EXIT_SUCCESS);
+}
@@ -12,6 +12,9 @@
  *              total words in the set are printed.  If the second file is
  *              given then all words in the second file are deleted from
  *              the set and the count printed.
+ *
+ *              The string hash function is chosen by the STRHASH
+ *              environment variable, and defaults to the legacy hash.
  */
 
 # include <stdio.h>
@@ -19,6 +22,7 @@
 # include <string.h>
 # include <stdbool.h>
 # include "set.h"
+# include "hashes.h"
 
 
 /* This is sufficient for the test cases in /scratch/coen12. */
@@ -26,24 +30,6 @@
 # define MAX_SIZE 18000
 
 
-/*
- * Function:    strhash
- *
- * Description: Return a hash value for a string S.
- */
-
-static unsigned strhash(char *s)
-{
-    unsigned hash = 0;
-
-
-    while (*s != '\0')
-        hash = 31 * hash + *s ++;
-
-    return hash;
-}
-
-
 /*
  * Function:    main
  *
@@ -53,10 +39,10 @@ static unsigned strhash(char *s)
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ], **elts, *word;
+    char buffer[BUFSIZ], *word;
     SET *unique;
     int i, words;
-    bool lflag = false;
+    bool found, lflag = false;
 
 
     /* Check usage and open the first file. */
@@ -74,6 +60,11 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    if (!selectHash(NULL)) {
+        fprintf(stderr, "%s: unknown hash function %s\n", argv[0], getenv("STRHASH"));
+        exit(EXIT_FAILURE);
+    }
+
     if ((fp = fopen(argv[1], "r")) == NULL) {
         fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
         exit(EXIT_FAILURE);
@@ -83,12 +74,18 @@ int main(int argc, char *argv[])
     /* Insert all words into the set. */
 
     words = 0;
-    unique = createSet(MAX_SIZE, strcmp, strhash);
+    unique = createSet(MAX_SIZE, strcmp, hashString);
 
     while (fscanf(fp, "%s", buffer) == 1) {
         words ++;
-	if (!findElement(unique, buffer))
-	    addElement(unique, strdup(buffer));
+
+	if (findElement(unique, buffer) == NULL) {
+	    word = strdup(buffer);
+	    upsertElement(unique, word, &found);
+
+	    if (found)
+		free(word);
+	}
     }
 
     fclose(fp);
@@ -126,14 +123,9 @@ int main(int argc, char *argv[])
 
     /* Print the list of words if desired. */
 
-    if (lflag) {
-	elts = getElements(unique);
-
-	for (i = 0; i < numElements(unique); i ++)
-	    printf("%s\n", elts[i]);
-
-	free(elts);
-    }
+    if (lflag)
+	for (word = firstElement(unique); word != NULL; word = nextElement(unique))
+	    printf("%s\n", word);
 
     destroySet(unique);
     exit(EXIT_SUCCESS);
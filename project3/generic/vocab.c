@@ -0,0 +1,139 @@
+/*
+ * File:        vocab.c
+ *
+ * Description: This file contains the main function for testing a set
+ *              abstract data type for strings shared between threads.
+ *
+ *              The program takes one or more files as command line
+ *              arguments and starts one thread per file.  Every thread
+ *              inserts the words of its file into the same set, and the
+ *              counts of total words and total words in the set are
+ *              printed.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <pthread.h>
+# include "set.h"
+
+
+/* This is sufficient for the test cases in /scratch/coen12. */
+
+# define MAX_SIZE 18000
+
+
+static SET *vocab;
+
+
+/*
+ * Function:    strhash
+ *
+ * Description: Return a hash value for a string S.
+ */
+
+static unsigned strhash(char *s)
+{
+    unsigned hash = 0;
+
+
+    while (*s != '\0')
+        hash = 31 * hash + *s ++;
+
+    return hash;
+}
+
+
+/*
+ * Function:    readWords
+ *
+ * Description: Thread function that inserts all words in the open file FP
+ *              into the shared set, and returns the number of words read.
+ *              A copy of a word is only kept if no other thread stored an
+ *              equal word first, which upsertElement reports.  A word
+ *              found by the first findElement is not copied at all.
+ */
+
+static void *readWords(void *fp)
+{
+    char buffer[BUFSIZ], *word;
+    long words = 0;
+    bool found;
+
+
+    while (fscanf(fp, "%s", buffer) == 1) {
+        words ++;
+
+	if (findElement(vocab, buffer) == NULL) {
+	    word = strdup(buffer);
+	    upsertElement(vocab, word, &found);
+
+	    if (found)
+		free(word);
+	}
+    }
+
+    fclose(fp);
+    return (void *) words;
+}
+
+
+/*
+ * Function:    main
+ *
+ * Description: Driver function for the test application.
+ */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    pthread_t *threads;
+    void *result;
+    char *word;
+    long words;
+    int i;
+
+
+    /* Check usage and open the files. */
+
+    if (argc == 1) {
+        fprintf(stderr, "usage: %s file ...\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    vocab = createSet(MAX_SIZE, strcmp, strhash);
+    threads = malloc(sizeof(pthread_t) * (argc - 1));
+
+    for (i = 1; i < argc; i ++) {
+	if ((fp = fopen(argv[i], "r")) == NULL) {
+	    fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[i]);
+	    exit(EXIT_FAILURE);
+	}
+
+	pthread_create(&threads[i - 1], NULL, readWords, fp);
+    }
+
+
+    /* Wait for the threads and print the counts. */
+
+    words = 0;
+
+    for (i = 1; i < argc; i ++) {
+	pthread_join(threads[i - 1], &result);
+	words += (long) result;
+    }
+
+    printf("%ld total words\n", words);
+    printf("%d distinct words\n", numElements(vocab));
+
+
+    /* Deallocate the words kept in the set. */
+
+    for (word = firstElement(vocab); word != NULL; word = nextElement(vocab))
+	free(word);
+
+    free(threads);
+    destroySet(vocab);
+    exit(EXIT_SUCCESS);
+}
@@ -5,19 +5,38 @@
  *
  * table.c
  * Implementation of a hash table for strings using open addressing
- * with linear probing. Elements are stored in an array with flags
- * indicating Empty, Filled, or Deleted states.
+ * with linear probing. Each slot holds the state flag (Empty, Filled, or
+ * Deleted), the full hash and length of its string, and the string
+ * itself, so a probe touches one array and most mismatches are rejected
+ * without reading the string. Strings shorter than INLINE bytes are copied
+ * into the slot; longer ones are copied into an arena of large chunks
+ * owned by the set. Space freed by removals is tracked and the arena is
+ * compacted once more than half of it is wasted, and destroying the set
+ * just unmaps its chunks. Once Deleted slots make up more than
+ * TOMBSTONE_LIMIT of the table, the probe chains are rebuilt in place.
  *
  * Big O Time Complexities:
  * createSet: O(m) - where m is maxElts
- * destroySet: O(m) 
+ * destroySet: O(c) - where c is the number of arena chunks
  * numElements: O(1)
  * addElement: O(1) average, O(m) worst case
  * removeElement: O(1) average, O(m) worst case
+ * toggleElement: O(1) average, O(m) worst case
  * findElement: O(1) average, O(m) worst case
- * getElements: O(m) 
+ * getElements: O(m)
+ * firstElement: O(m) worst case
+ * nextElement: O(m) worst case, O(m) for a whole iteration 
  * search: O(1) average, O(m) worst case
  * strhash: O(n) - where n is the length of the string
+ * matches: O(1) unless hash and length agree, then O(n)
+ * keyOf: O(1)
+ * arenaCopy: O(n) - where n is the length of the string
+ * arenaFree: O(1)
+ * compact: O(m)
+ * cleanup: O(m) average case
+ * insert: O(n) - where n is the length of the string
+ * erase: O(1), or O(m) when it compacts or cleans up
+ * getSetStats: O(m + c), only with SET_STATS
  */
 
 #include <stdlib.h>
@@ -26,34 +45,278 @@
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <sys/mman.h>
 
 #define EMPTY 'E'
 #define FILLED 'F'
 #define DELETED 'D'
+#define REHASH 'R'
+
+/* fraction of the table that may be Deleted before cleanup runs; may be
+ * overridden when compiling, e.g. -DTOMBSTONE_LIMIT=0.5 */
+#ifndef TOMBSTONE_LIMIT
+#define TOMBSTONE_LIMIT 0.25
+#endif
+
+/* lengths are saturated at MAXLEN; strings that long always fall back to
+ * strcmp once their hashes agree */
+#define MAXLEN USHRT_MAX
+
+/* strings of fewer than INLINE bytes, not counting the null, are stored
+ * in the slot itself */
+#define INLINE 16
+
+/* minimum size of an arena chunk, and the amount of wasted space below
+ * which the arena is never compacted */
+#define CHUNK (64 * 1024)
+
+struct chunk {
+	struct chunk *next;
+	size_t size;		/* bytes mapped, including this header */
+	size_t used;		/* bytes handed out, including this header */
+};
+
+struct slot {
+	unsigned hash;
+	unsigned short length;
+	char flag;
+	union {
+		char *ptr;
+		char buf[INLINE];
+	} key;
+};
 
 typedef struct set {
 	size_t count;
 	size_t length;
-	char **data;
-    char *flags;
+	size_t deleted;
+	struct slot *slots;
+	struct chunk *arena;	/* chunk being filled, linked to older ones */
+	size_t live;		/* arena bytes in use by Filled slots */
+	size_t wasted;		/* arena bytes released by removals */
+	size_t cursor;		/* next slot to visit while iterating */
+#ifdef SET_STATS
+	struct setstats stats;
+#endif
 } SET;
 
-/* strhash: compute hash value for a string using polynomial rolling hash.
+#ifdef SET_STATS
+/* private helper: count a search that examined probes slots after the home
+ * slot in the histogram hist.
+ * Big O: O(1)
+ */
+static void countProbe(SET *sp, unsigned long *hist, size_t probes) {
+	hist[probes < STATS_BUCKETS - 1 ? probes : STATS_BUCKETS - 1]++;
+	if (probes > sp->stats.maxProbe) {
+		sp->stats.maxProbe = probes;
+	}
+}
+
+/* private helper: print the statistics of the set to stderr.
+ * Big O: O(m)
+ */
+static void dumpStats(SET *sp) {
+	struct setstats st;
+	int i;
+	getSetStats(sp, &st);
+	fprintf(stderr, "set: %zu live, %zu tombstones, %zu empty, %zu rehashes\n",
+		st.live, st.tombstones, st.empty, st.rehashes);
+	fprintf(stderr, "set: %zu slot bytes, %zu key bytes, longest probe %zu\n",
+		st.slotBytes, st.keyBytes, st.maxProbe);
+	fprintf(stderr, "set: hits by probe length:");
+	for (i = 0; i < STATS_BUCKETS; i++) {
+		fprintf(stderr, " %lu", st.hits[i]);
+	}
+	fprintf(stderr, "\nset: misses by probe length:");
+	for (i = 0; i < STATS_BUCKETS; i++) {
+		fprintf(stderr, " %lu", st.misses[i]);
+	}
+	fprintf(stderr, "\n");
+}
+
+#define COUNT_HIT(sp, probes) countProbe(sp, (sp)->stats.hits, probes)
+#define COUNT_MISS(sp, probes) countProbe(sp, (sp)->stats.misses, probes)
+#define COUNT_REHASH(sp) ((sp)->stats.rehashes++)
+#else
+#define COUNT_HIT(sp, probes)
+#define COUNT_MISS(sp, probes)
+#define COUNT_REHASH(sp)
+#endif
+
+/* strhash: compute hash value for a string using polynomial rolling hash,
+ * and store the length of the string in *len.
  * Big O: O(n) - where n is the length of the string
  */
-unsigned strhash(char *s) {
+unsigned strhash(char *s, size_t *len) {
 	unsigned hash = 0;
+	char *p = s;
 	assert(s != NULL);
-	while ( *s != '\0') {
-		hash = 31 * hash + *s++;
+	while ( *p != '\0') {
+		hash = 31 * hash + *p++;
 	}
+	*len = p - s;
 	return hash;
 }
 
-static int search(SET *sp, char *elt, bool *found);
+static int search(SET *sp, char *elt, unsigned hash, size_t len, bool *found);
+
+/* keyOf: return the string held by a Filled slot, either inline or on
+ * the heap depending on its length.
+ * Big O: O(1)
+ */
+static char *keyOf(struct slot *slot) {
+	return slot->length < INLINE ? slot->key.buf : slot->key.ptr;
+}
+
+/* arenaCopy: copy the string elt of length len into the arena, mapping a
+ * new chunk if the current one is too full, and return the copy.
+ * Big O: O(n) - where n is the length of the string
+ */
+static char *arenaCopy(SET *sp, char *elt, size_t len) {
+	struct chunk *cp = sp->arena;
+	char *copy;
+	if (cp == NULL || cp->used + len + 1 > cp->size) {
+		size_t size = sizeof(struct chunk) + len + 1;
+		size = size < CHUNK ? CHUNK : size;
+		cp = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		assert(cp != MAP_FAILED);
+		cp->next = sp->arena;
+		cp->size = size;
+		cp->used = sizeof(struct chunk);
+		sp->arena = cp;
+	}
+	copy = (char *) cp + cp->used;
+	memcpy(copy, elt, len + 1);
+	cp->used += len + 1;
+	sp->live += len + 1;
+	return copy;
+}
+
+/* arenaFree: release the arena copy of a string of length len. The space
+ * is reused at once if it was the last copy made, and otherwise only
+ * counted as wasted until the next compaction.
+ * Big O: O(1)
+ */
+static void arenaFree(SET *sp, char *copy, size_t len) {
+	struct chunk *cp = sp->arena;
+	sp->live -= len + 1;
+	if (copy + len + 1 == (char *) cp + cp->used) {
+		cp->used -= len + 1;
+	}
+	else {
+		sp->wasted += len + 1;
+	}
+}
+
+/* compact: copy the strings of all Filled slots into fresh chunks and
+ * unmap the old ones, discarding the wasted space.
+ * Big O: O(m)
+ */
+static void compact(SET *sp) {
+	struct chunk *cp = sp->arena, *next;
+	sp->arena = NULL;
+	sp->live = 0;
+	sp->wasted = 0;
+	for (int i = 0; i < sp->length; i++) {
+		struct slot *slot = &sp->slots[i];
+		if (slot->flag == FILLED && slot->length >= INLINE) {
+			size_t len = slot->length < MAXLEN ? slot->length : strlen(slot->key.ptr);
+			slot->key.ptr = arenaCopy(sp, slot->key.ptr, len);
+		}
+	}
+	while (cp != NULL) {
+		next = cp->next;
+		munmap(cp, cp->size);
+		cp = next;
+	}
+}
+
+/* cleanup: turn every Deleted slot back into Empty and move each element
+ * to the first free slot of its probe sequence, without a second table.
+ * Filled slots are first marked Rehash. Each Rehash element is then
+ * placed at the first Empty or Rehash slot from its home; if that slot
+ * held another Rehash element, the two are swapped and the one now at i
+ * is placed next. Slots marked Filled never move again, so every probe
+ * chain ends up unbroken.
+ * Big O: O(m) average case
+ */
+static void cleanup(SET *sp) {
+	struct slot temp;
+	size_t i, j;
+	COUNT_REHASH(sp);
+	for (i = 0; i < sp->length; i++) {
+		sp->slots[i].flag = sp->slots[i].flag == FILLED ? REHASH : EMPTY;
+	}
+	for (i = 0; i < sp->length; i++) {
+		while (sp->slots[i].flag == REHASH) {
+			j = sp->slots[i].hash % sp->length;
+			while (sp->slots[j].flag == FILLED) {
+				j = (j + 1) % sp->length;
+			}
+			if (j == i) {
+				sp->slots[i].flag = FILLED;
+			}
+			else if (sp->slots[j].flag == EMPTY) {
+				sp->slots[j] = sp->slots[i];
+				sp->slots[j].flag = FILLED;
+				sp->slots[i].flag = EMPTY;
+			}
+			else {
+				temp = sp->slots[j];
+				sp->slots[j] = sp->slots[i];
+				sp->slots[j].flag = FILLED;
+				sp->slots[i] = temp;
+			}
+		}
+	}
+	sp->deleted = 0;
+}
+
+/* insert: store a copy of elt, which is not present and has the given hash
+ * and length, in slot idx as found by search.
+ * Big O: O(n) - where n is the length of the string
+ */
+static void insert(SET *sp, char *elt, unsigned hash, size_t len, int idx) {
+	assert(sp->count < sp->length);
+	if (len < INLINE) {
+		memcpy(sp->slots[idx].key.buf, elt, len + 1);
+	}
+	else {
+		sp->slots[idx].key.ptr = arenaCopy(sp, elt, len);
+	}
+	if (sp->slots[idx].flag == DELETED) {
+		sp->deleted--;
+	}
+	sp->slots[idx].hash = hash;
+	sp->slots[idx].length = len < MAXLEN ? len : MAXLEN;
+	sp->slots[idx].flag = FILLED;
+	sp->count++;
+}
+
+/* erase: mark the Filled slot idx, whose string has length len, as Deleted
+ * and release its string. Compacts the arena once more of it is wasted
+ * than in use, and cleans up the table once too many slots are Deleted.
+ * Big O: O(1), or O(m) when it compacts or cleans up
+ */
+static void erase(SET *sp, int idx, size_t len) {
+	sp->slots[idx].flag = DELETED;
+	sp->deleted++;
+	sp->count--;
+	if (len >= INLINE) {
+		arenaFree(sp, sp->slots[idx].key.ptr, len);
+		if (sp->wasted > CHUNK && sp->wasted > sp->live) {
+			compact(sp);
+		}
+	}
+	if (sp->deleted > sp->length * TOMBSTONE_LIMIT) {
+		cleanup(sp);
+	}
+}
 
 /* createSet: allocate and initialize a new hash table SET holding up to
- * maxElts elements. Initializes the data array and flags array.
+ * maxElts elements. Initializes the slot array.
  * Big O: O(m) 
  */
 SET *createSet(int maxElts) {
@@ -63,29 +326,40 @@ SET *createSet(int maxElts) {
 	assert(maxElts > 0);
 	sp->count = 0;
 	sp->length = maxElts;
-	sp->data = malloc(sizeof(char*) * maxElts);
-	assert(sp->data != NULL);
-	sp->flags = malloc(sizeof(char) * maxElts);
-	assert(sp->flags != NULL);
+	sp->deleted = 0;
+	sp->arena = NULL;
+	sp->live = 0;
+	sp->wasted = 0;
+	sp->cursor = 0;
+#ifdef SET_STATS
+	memset(&sp->stats, 0, sizeof(sp->stats));
+#endif
+	sp->slots = malloc(sizeof(struct slot) * maxElts);
+	assert(sp->slots != NULL);
 	for (int i = 0; i < maxElts; i++) {
-		sp->flags[i] = EMPTY;
+		sp->slots[i].flag = EMPTY;
 	}
 	return sp;
 }
 
-/* destroySet: free all strings owned by the set (marked as Filled),
- * the data and flags arrays, and the set structure.
- * Big O: O(m) 
+/* destroySet: unmap the arena chunks holding the strings owned by the set,
+ * and free the slot array and the set structure.
+ * Big O: O(c) - where c is the number of arena chunks
  */
 void destroySet(SET *sp) {
 	assert(sp != NULL);
-	for (int i = 0; i < sp->length; i++) {
-		if (sp->flags[i] == FILLED) {
-			free(sp->data[i]);
-		}
+	struct chunk *cp = sp->arena, *next;
+#ifdef SET_STATS
+	if (getenv("SET_STATS") != NULL) {
+		dumpStats(sp);
+	}
+#endif
+	while (cp != NULL) {
+		next = cp->next;
+		munmap(cp, cp->size);
+		cp = next;
 	}
-	free(sp->data);
-	free(sp->flags);
+	free(sp->slots);
 	free(sp);
 }
 
@@ -97,22 +371,19 @@ int numElements(SET *sp) {
 	return sp->count;
 }
 
-/* addElement: insert elt in the hash table using linear probing.
- * Duplicates are not added.
+/* addElement: insert a copy of elt in the hash table using linear probing.
+ * Duplicates are not added. Short strings are copied into the slot, and
+ * longer ones into the arena.
  * Big O: O(1) average case, O(m) worst case
  */
 void addElement(SET *sp, char *elt) {
 	assert((elt != NULL) && (sp != NULL));	
 	bool found;
-	char* newElt;
-	int idx = search(sp, elt, &found);
+	size_t len;
+	unsigned hash = strhash(elt, &len);
+	int idx = search(sp, elt, hash, len, &found);
 	if (!found) {
-		assert(sp->count < sp->length);
-		newElt = strdup(elt);
-		assert(newElt != NULL);
-		sp->data[idx] = newElt;
-		sp->flags[idx] = FILLED;
-		sp->count++;
+		insert(sp, elt, hash, len, idx);
 	}
 }
 
@@ -123,26 +394,47 @@ void addElement(SET *sp, char *elt) {
 void removeElement(SET *sp, char *elt) {
 	assert((sp != NULL) && (elt != NULL));
 	bool found;
-	int idx = search(sp, elt, &found);
+	size_t len;
+	unsigned hash = strhash(elt, &len);
+	int idx = search(sp, elt, hash, len, &found);
+	if (found) {
+		erase(sp, idx, len);
+	}
+}
+
+/* toggleElement: insert a copy of elt if it is not present, or remove it if
+ * it is, with a single hash and probe. Returns true if elt was inserted.
+ * Big O: O(1) average case, O(m) worst case
+ */
+bool toggleElement(SET *sp, char *elt) {
+	assert((sp != NULL) && (elt != NULL));
+	bool found;
+	size_t len;
+	unsigned hash = strhash(elt, &len);
+	int idx = search(sp, elt, hash, len, &found);
 	if (found) {
-		free(sp->data[idx]);
-		sp->flags[idx] = DELETED;
-		sp->count--;
+		erase(sp, idx, len);
+		return false;
 	}
+	insert(sp, elt, hash, len, idx);
+	return true;
 }
 
 /* findElement: return pointer to stored string equal to elt using hash table
- * lookup, or NULL if not found.
+ * lookup, or NULL if not found. The pointer may point into the table or
+ * the arena, so it is only valid until the next removal.
  * Big O: O(1) average case, O(m) worst case
  */
 char *findElement(SET *sp, char *elt) {
 	assert((sp != NULL) && (elt != NULL));
 	bool found;
-	int idx = search(sp, elt, &found);
+	size_t len;
+	unsigned hash = strhash(elt, &len);
+	int idx = search(sp, elt, hash, len, &found);
 	if (!found) {
 		return NULL;
 	}
-	return sp->data[idx];
+	return keyOf(&sp->slots[idx]);
 }
 
 /* getElements: return a newly-allocated array of pointers to the elements
@@ -156,50 +448,121 @@ char **getElements(SET *sp) {
 	assert(cpy != NULL);
 	int j = 0;
 	for (int i = 0; i < sp->length; i++) {
-		if (sp->flags[i] == FILLED) {
-			cpy[j] = sp->data[i];
+		if (sp->slots[i].flag == FILLED) {
+			cpy[j] = keyOf(&sp->slots[i]);
 			j++;
 		}
 	}
 	return cpy;
 }
 
+/* firstElement: start an iteration over the elements stored in the set and
+ * return the first one, or NULL if the set is empty. The strings are
+ * returned where they are stored, in the slot or the arena, without
+ * allocating. The set must not be changed until nextElement returns NULL.
+ * Big O: O(m) worst case
+ */
+char *firstElement(SET *sp) {
+	assert(sp != NULL);
+	sp->cursor = 0;
+	return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by
+ * firstElement, or NULL once every element has been returned.
+ * Big O: O(m) worst case, O(m) for a whole iteration
+ */
+char *nextElement(SET *sp) {
+	assert(sp != NULL);
+	while (sp->cursor < sp->length) {
+		struct slot *s = &sp->slots[sp->cursor++];
+		if (s->flag == FILLED) {
+			return keyOf(s);
+		}
+	}
+	return NULL;
+}
+
+#ifdef SET_STATS
+/* getSetStats: store the statistics of the set in *stats. The key bytes
+ * are the arena chunks mapped for strings too long to be kept inline.
+ * Big O: O(m + c) - where c is the number of arena chunks
+ */
+void getSetStats(SET *sp, struct setstats *stats) {
+	assert((sp != NULL) && (stats != NULL));
+	*stats = sp->stats;
+	for (size_t i = 0; i < sp->length; i++) {
+		if (sp->slots[i].flag == FILLED) {
+			stats->live++;
+		}
+		else if (sp->slots[i].flag == DELETED) {
+			stats->tombstones++;
+		}
+		else {
+			stats->empty++;
+		}
+	}
+	stats->slotBytes = sp->length * sizeof(struct slot);
+	for (struct chunk *cp = sp->arena; cp != NULL; cp = cp->next) {
+		stats->keyBytes += cp->size;
+	}
+}
+#endif
+
+
+/* private helper: return true if the Filled slot holds the string elt,
+ * whose hash and length are given. The string itself is only read when
+ * both the stored hash and length agree.
+ * Big O: O(1) unless hash and length agree, then O(n)
+ */
+static bool matches(struct slot *slot, char *elt, unsigned hash, size_t len) {
+	if (slot->hash != hash || slot->length != (len < MAXLEN ? len : MAXLEN)) {
+		return false;
+	}
+	if (len < MAXLEN) {
+		return memcmp(keyOf(slot), elt, len) == 0;
+	}
+	return strcmp(keyOf(slot), elt) == 0;
+}
 
 /* private helper: returns the index of element in hash table or the index
  * where you would insert it, found using linear probing from the hash value.
  * Returns the first Deleted slot encountered if element is not found.
  * Big O: O(1) average case, O(m) worst case
  */
-static int search(SET *sp, char *elt, bool *found) {
+static int search(SET *sp, char *elt, unsigned hash, size_t len, bool *found) {
 	assert(sp != NULL);
 
-	int idx = strhash(elt) % sp->length;
+	int idx = hash % sp->length;
 	int i = 0;
 	int firstDeleted = -1;
 	int locn;
 	
 	while (i < sp->length) {
 		locn = (idx + i ) % sp->length;
-		if (sp->flags[locn] == DELETED) {
+		if (sp->slots[locn].flag == DELETED) {
 			if (firstDeleted == -1) {
 				firstDeleted = locn;
 			}
 		}
-		else if (sp->flags[locn] == EMPTY) {
+		else if (sp->slots[locn].flag == EMPTY) {
+			COUNT_MISS(sp, i);
 			*found = false;
 			if (firstDeleted == -1) {
 				return locn;
 			}
 			return firstDeleted;
 		}
-		else if (sp->flags[locn] == FILLED) {
-			if (strcmp(sp->data[locn], elt) == 0) {
+		else if (sp->slots[locn].flag == FILLED) {
+			if (matches(&sp->slots[locn], elt, hash, len)) {
+				COUNT_HIT(sp, i);
 				*found = true;
 				return locn;
 			}
 		}
 		i++;
 	}
+	COUNT_MISS(sp, i);
 	*found = false; 
 	return firstDeleted;
 }
@@ -0,0 +1,280 @@
+/*
+ * Gordon Wu
+ * CSEN12
+ * 11/09/2025
+ *
+ * flatset.c
+ * Implementation of a set abstract data type using a hash table with chaining,
+ * where each bucket is a contiguous array of (hash, element) pairs instead of
+ * a linked list. A lookup reads the bucket and then scans its pairs in order,
+ * calling the compare function only when the stored hash matches. The number
+ * of buckets doubles whenever the average chain would grow past ALPHA, and
+ * since each pair keeps its full hash the elements are never rehashed.
+ *
+ * Big O Time Complexities:
+ * createSet: O(m) where m is the number of buckets
+ * destroySet: O(m) where m is the number of buckets
+ * numElements: O(1)
+ * addElement: O(1) amortized average case, O(n) worst case where n is total elements
+ * removeElement: O(1) average case, O(n) worst case where n is total elements
+ * findElement: O(1) average case, O(n) worst case where n is total elements
+ * toggleElement: O(1) amortized average case, O(n) worst case where n is total elements
+ * getElements: O(n + m) where n is total elements and m is the number of buckets
+ * firstElement: O(m) worst case where m is the number of buckets
+ * nextElement: O(m) worst case, O(n + m) for a whole iteration
+ * grow: O(n + m) where n is total elements and m is the number of buckets
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "set.h"
+
+#define ALPHA 2
+
+struct pair {
+    unsigned hash;
+    void *elt;
+};
+
+struct bucket {
+    int count;
+    int capacity;
+    struct pair *pairs;
+};
+
+struct set {
+    int length;
+    int count;
+    int cursor;                 /* bucket being visited while iterating */
+    int offset;                 /* next pair of that bucket to visit */
+    int (*compare)();
+    unsigned (*hash)();
+    struct bucket *buckets;
+};
+
+
+/* private helper: append the pair (hash, elt) to the bucket bp, doubling its
+ * array if it is full, and return the address of the new pair.
+ * Big O: O(1) amortized
+ */
+static struct pair *append(struct bucket *bp, unsigned hash, void *elt)
+{
+    if (bp->count == bp->capacity)
+    {
+        bp->capacity = bp->capacity > 0 ? bp->capacity * 2 : ALPHA;
+        bp->pairs = realloc(bp->pairs, sizeof(struct pair) * bp->capacity);
+        assert(bp->pairs != NULL);
+    }
+    bp->pairs[bp->count].hash = hash;
+    bp->pairs[bp->count].elt = elt;
+    return &bp->pairs[bp->count++];
+}
+
+/* private helper: return the index of the pair holding an element equal to elt
+ * in the bucket bp, or -1 if there is none.
+ * Big O: O(1) average case, O(n) worst case where n is total elements
+ */
+static int search(SET *sp, struct bucket *bp, void *elt, unsigned hash)
+{
+    for (int i = 0; i < bp->count; i++)
+        if (bp->pairs[i].hash == hash && (*sp->compare)(bp->pairs[i].elt, elt) == 0)
+            return i;
+    return -1;
+}
+
+/* private helper: remove the pair at index i of the bucket bp by moving the
+ * last pair into its place.
+ * Big O: O(1)
+ */
+static void erase(struct bucket *bp, int i)
+{
+    bp->pairs[i] = bp->pairs[--bp->count];
+}
+
+/* private helper: double the number of buckets, moving each pair to the bucket
+ * chosen by its stored hash.
+ * Big O: O(n + m) where n is total elements and m is the number of buckets
+ */
+static void grow(SET *sp)
+{
+    struct bucket *old = sp->buckets;
+    int oldLength = sp->length;
+    sp->length *= 2;
+    sp->buckets = calloc(sp->length, sizeof(struct bucket));
+    assert(sp->buckets != NULL);
+    for (int i = 0; i < oldLength; i++)
+    {
+        for (int j = 0; j < old[i].count; j++)
+        {
+            unsigned hash = old[i].pairs[j].hash;
+            append(&sp->buckets[hash % sp->length], hash, old[i].pairs[j].elt);
+        }
+        free(old[i].pairs);
+    }
+    free(old);
+}
+
+/* createSet: allocate and initialize a new hash table SET with m = maxElts/ALPHA buckets.
+ * Big O: O(m) where m is the number of buckets
+ */
+SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
+{
+    SET *sp;
+    assert(compare != NULL && hash != NULL);
+    assert(maxElts > 0);
+    sp = malloc(sizeof(SET));
+    assert(sp != NULL);
+    sp->compare = compare;
+    sp->hash = hash;
+    sp->count = 0;
+    sp->cursor = 0;
+    sp->offset = 0;
+    sp->length = maxElts / ALPHA > 0 ? maxElts / ALPHA : 1;
+    sp->buckets = calloc(sp->length, sizeof(struct bucket));
+    assert(sp->buckets != NULL);
+    return sp;
+}
+
+/* destroySet: deallocate all memory associated with the set pointed to by sp.
+ * Frees every bucket array and the set structure itself.
+ * Big O: O(m) where m is the number of buckets
+ */
+void destroySet(SET *sp)
+{
+    assert(sp != NULL);
+    for (int i = 0; i < sp->length; i++)
+        free(sp->buckets[i].pairs);
+    free(sp->buckets);
+    free(sp);
+}
+
+/* numElements: return the number of elements in the set pointed to by sp.
+ * Big O: O(1)
+ */
+int numElements(SET *sp)
+{
+    assert(sp != NULL);
+    return sp->count;
+}
+
+/* addElement: add elt to the set pointed to by sp if it is not already present.
+ * Big O: O(1) amortized average case, O(n) worst case where n is total elements
+ */
+void addElement(SET *sp, void *elt)
+{
+    assert(sp != NULL && elt != NULL);
+    unsigned hash = (*sp->hash)(elt);
+    if (search(sp, &sp->buckets[hash % sp->length], elt, hash) == -1)
+    {
+        if (sp->count >= sp->length * ALPHA)
+            grow(sp);
+        append(&sp->buckets[hash % sp->length], hash, elt);
+        sp->count++;
+    }
+}
+
+/* removeElement: remove elt from the set pointed to by sp if it exists.
+ * Big O: O(1) average case, O(n) worst case where n is total elements
+ */
+void removeElement(SET *sp, void *elt)
+{
+    assert(sp != NULL && elt != NULL);
+    unsigned hash = (*sp->hash)(elt);
+    struct bucket *bp = &sp->buckets[hash % sp->length];
+    int i = search(sp, bp, elt, hash);
+    if (i != -1)
+    {
+        erase(bp, i);
+        sp->count--;
+    }
+}
+
+/* toggleElement: add elt to the set pointed to by sp if it is not present, or
+ * remove the equal element if it is, hashing once and scanning the bucket once.
+ * On removal the removed element is stored in *removed and NULL is returned. On
+ * insertion the address of the new element is returned so the caller can replace
+ * elt with an equal element it owns.
+ * Big O: O(1) amortized average case, O(n) worst case where n is total elements
+ */
+void **toggleElement(SET *sp, void *elt, void **removed)
+{
+    assert(sp != NULL && elt != NULL && removed != NULL);
+    unsigned hash = (*sp->hash)(elt);
+    struct bucket *bp = &sp->buckets[hash % sp->length];
+    int i = search(sp, bp, elt, hash);
+    if (i != -1)
+    {
+        *removed = bp->pairs[i].elt;
+        erase(bp, i);
+        sp->count--;
+        return NULL;
+    }
+    if (sp->count >= sp->length * ALPHA)
+    {
+        grow(sp);
+        bp = &sp->buckets[hash % sp->length];
+    }
+    sp->count++;
+    return &append(bp, hash, elt)->elt;
+}
+
+/* findElement: if elt is present in the set pointed to by sp then return the
+ * matching element, otherwise return NULL.
+ * Big O: O(1) average case, O(n) worst case where n is total elements
+ */
+void *findElement(SET *sp, void *elt)
+{
+    assert(sp != NULL && elt != NULL);
+    unsigned hash = (*sp->hash)(elt);
+    struct bucket *bp = &sp->buckets[hash % sp->length];
+    int i = search(sp, bp, elt, hash);
+    return i != -1 ? bp->pairs[i].elt : NULL;
+}
+
+/* getElements: allocate and return an array of all elements in the set pointed to by sp.
+ * Big O: O(n + m) where n is total elements and m is the number of buckets
+ */
+void *getElements(SET *sp)
+{
+    assert(sp != NULL);
+    void **copy = malloc(sizeof(void*) * (sp->count > 0 ? sp->count : 1));
+    assert(copy != NULL);
+    int idx = 0;
+    for (int i = 0; i < sp->length; i++)
+        for (int j = 0; j < sp->buckets[i].count; j++)
+            copy[idx++] = sp->buckets[i].pairs[j].elt;
+    return copy;
+}
+
+/* firstElement: start an iteration over the set pointed to by sp and return its
+ * first element, or NULL if the set is empty. The bucket arrays are read in
+ * place, so nothing is allocated. The set must not be changed until
+ * nextElement returns NULL.
+ * Big O: O(m) worst case where m is the number of buckets
+ */
+void *firstElement(SET *sp)
+{
+    assert(sp != NULL);
+    sp->cursor = 0;
+    sp->offset = 0;
+    return nextElement(sp);
+}
+
+/* nextElement: return the next element of the iteration started by firstElement,
+ * or NULL once every element has been returned.
+ * Big O: O(m) worst case, O(n + m) for a whole iteration
+ */
+void *nextElement(SET *sp)
+{
+    assert(sp != NULL);
+    while (sp->cursor < sp->length)
+    {
+        if (sp->offset < sp->buckets[sp->cursor].count)
+            return sp->buckets[sp->cursor].pairs[sp->offset++].elt;
+        sp->cursor++;
+        sp->offset = 0;
+    }
+    return NULL;
+}
@@ -18,7 +18,12 @@
  * getLast: O(1)
  * removeItem: O(n)
  * findItem: O(n) where n is the number of items in the list
+ * toggleItem: O(n) where n is the number of items in the list
  * getItems: O(n) where n is the number of items in the list
+ * firstItem: O(1)
+ * nextItem: O(1)
+ * listBytes: O(1)
+ * findPosition: O(n) where n is the number of items in the list
  */
 
 #include <stdlib.h>
@@ -29,6 +34,7 @@
 struct list {
     int count;
     struct node *head;
+    struct node *cursor;
     int (*compare)();
 };
 
@@ -54,6 +60,7 @@ LIST *createList(int (*compare)()) {
     assert(lp->head != NULL);
     lp->head->next = lp->head;
     lp->head->prev = lp->head;
+    lp->cursor = lp->head;
     return lp;
 }
 
@@ -192,6 +199,30 @@ void *findItem(LIST *lp, void *item) {
     return NULL;
 }
 
+/* toggleItem: if an item equal to item is present in the list pointed to by lp,
+ * unlink it, store it in *removed, and return NULL. Otherwise add item as the
+ * first element and return the address of its data so the caller may replace it
+ * with an equal item.
+ * Big O: O(n) where n is the number of items in the list
+ */
+void **toggleItem(LIST *lp, void *item, void **removed) {
+    assert(lp != NULL && lp->compare != NULL && removed != NULL);
+    NODE *pCur = lp->head->next;
+    while (pCur != lp->head) {
+        if (lp->compare(pCur->data, item) == 0) {
+            pCur->prev->next = pCur->next;
+            pCur->next->prev = pCur->prev;
+            *removed = pCur->data;
+            free(pCur);
+            lp->count--;
+            return NULL;
+        }
+        pCur = pCur->next;
+    }
+    addFirst(lp, item);
+    return &lp->head->next->data;
+}
+
 /* getItems: allocate and return an array of all items in the list pointed to by lp.
  * Big O: O(n) 
  */
@@ -208,3 +239,53 @@ void *getItems(LIST *lp) {
     }
     return elts;
 }
+
+/* firstItem: start an iteration over the list pointed to by lp and return its
+ * first item, or NULL if the list is empty. The list must not be changed until
+ * nextItem returns NULL.
+ * Big O: O(1)
+ */
+void *firstItem(LIST *lp) {
+    assert(lp != NULL);
+    lp->cursor = lp->head;
+    return nextItem(lp);
+}
+
+/* nextItem: return the item after the one last returned by firstItem or
+ * nextItem, or NULL once the end of the list is reached.
+ * Big O: O(1)
+ */
+void *nextItem(LIST *lp) {
+    assert(lp != NULL);
+    if (lp->cursor->next == lp->head)
+        return NULL;
+    lp->cursor = lp->cursor->next;
+    return lp->cursor->data;
+}
+
+/* listBytes: return the number of bytes allocated for the list pointed to by lp,
+ * including its sentinel node but not the items themselves.
+ * Big O: O(1)
+ */
+size_t listBytes(LIST *lp) {
+    assert(lp != NULL);
+    return sizeof(LIST) + (lp->count + 1) * sizeof(NODE);
+}
+
+/* findPosition: return the position of the first item equal to item in the list
+ * pointed to by lp, counting from 1, or 0 if there is none. Used only for the
+ * set statistics, so that findItem and toggleItem need not count.
+ * Big O: O(n) where n is the number of items in the list
+ */
+int findPosition(LIST *lp, void *item) {
+    assert(lp != NULL && lp->compare != NULL);
+    NODE *pCur = lp->head->next;
+    int n = 1;
+    while (pCur != lp->head) {
+        if (lp->compare(pCur->data, item) == 0)
+            return n;
+        pCur = pCur->next;
+        n++;
+    }
+    return 0;
+}
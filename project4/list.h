@@ -13,6 +13,8 @@
 # ifndef LIST_H
 # define LIST_H
 
+# include <stddef.h>
+
 typedef struct list LIST;
 
 extern LIST *createList(int (*compare)());
@@ -37,6 +39,16 @@ extern void removeItem(LIST *lp, void *item);
 
 extern void *findItem(LIST *lp, void *item);
 
+extern void **toggleItem(LIST *lp, void *item, void **removed);
+
 extern void *getItems(LIST *lp);
 
+extern void *firstItem(LIST *lp);
+
+extern void *nextItem(LIST *lp);
+
+extern size_t listBytes(LIST *lp);
+
+extern int findPosition(LIST *lp, void *item);
+
 # endif /* LIST_H */
@@ -50,7 +50,8 @@ static unsigned strhash(char *s)
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ], *word;
+    char buffer[BUFSIZ];
+    void **slot, *word;
     SET *odd;
     int words;
 
@@ -76,11 +77,10 @@ int main(int argc, char *argv[])
     while (fscanf(fp, "%s", buffer) == 1) {
         words ++;
 
-        if ((word = findElement(odd, buffer)) != NULL) {
-            removeElement(odd, buffer);
+        if ((slot = toggleElement(odd, buffer, &word)) != NULL)
+            *slot = strdup(buffer);
+        else
 	    free(word);
-	} else
-            addElement(odd, strdup(buffer));
     }
 
     printf("%d total words\n", words);
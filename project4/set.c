@@ -13,7 +13,11 @@
  * addElement: O(1) average case, O(n) worst case where n is total elements
  * removeElement: O(1) average case, O(n) worst case where n is total elements
  * findElement: O(1) average case, O(n) worst case where n is total elements
+ * toggleElement: O(1) average case, O(n) worst case where n is total elements
  * getElements: O(n + m) where n is total elements and m is the number of lists
+ * firstElement: O(m) worst case where m is the number of lists
+ * nextElement: O(m) worst case, O(n + m) for a whole iteration
+ * getSetStats: O(m) where m is the number of lists, only with SET_STATS
  */
 
 #include <stdio.h>
@@ -28,11 +32,65 @@
 struct set {
     int length;
     int count;
+    int cursor;
     int (*compare)();
     unsigned (*hash)();
     LIST **lists;
+#ifdef SET_STATS
+    struct setstats stats;
+#endif
 };
 
+#ifdef SET_STATS
+/* countProbe: count a search that compared probes items in the histogram hist.
+ * Big O: O(1)
+ */
+static void countProbe(SET *sp, unsigned long *hist, size_t probes)
+{
+    hist[probes < STATS_BUCKETS - 1 ? probes : STATS_BUCKETS - 1]++;
+    if (probes > sp->stats.maxProbe)
+        sp->stats.maxProbe = probes;
+}
+
+/* dumpStats: print the statistics of the set pointed to by sp to stderr.
+ * Big O: O(n + m) where n is total elements and m is the number of lists
+ */
+static void dumpStats(SET *sp)
+{
+    struct setstats st;
+    getSetStats(sp, &st);
+    fprintf(stderr, "set: %zu live, %zu tombstones, %zu empty, %zu rehashes\n",
+        st.live, st.tombstones, st.empty, st.rehashes);
+    fprintf(stderr, "set: %zu slot bytes, %zu key bytes, longest probe %zu\n",
+        st.slotBytes, st.keyBytes, st.maxProbe);
+    fprintf(stderr, "set: hits by probe length:");
+    for (int i = 0; i < STATS_BUCKETS; i++)
+        fprintf(stderr, " %lu", st.hits[i]);
+    fprintf(stderr, "\nset: misses by probe length:");
+    for (int i = 0; i < STATS_BUCKETS; i++)
+        fprintf(stderr, " %lu", st.misses[i]);
+    fprintf(stderr, "\n");
+}
+
+/* countSearch: count a search for elt in the list pointed to by lp as a hit
+ * at the position of the matching element, or as a miss of the whole list. It
+ * must be called before the list is changed.
+ * Big O: O(n) where n is the number of items in the list
+ */
+static void countSearch(SET *sp, LIST *lp, void *elt)
+{
+    int position = findPosition(lp, elt);
+    if (position > 0)
+        countProbe(sp, sp->stats.hits, position);
+    else
+        countProbe(sp, sp->stats.misses, numItems(lp));
+}
+
+#define COUNT_SEARCH(sp, lp, elt) countSearch(sp, lp, elt)
+#else
+#define COUNT_SEARCH(sp, lp, elt)
+#endif
+
 
 /* createSet: allocate and initialize a new hash table SET with m = maxElts/ALPHA lists.
  * Big O: O(m) where m is the number of lists
@@ -47,6 +105,10 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
     sp->compare = compare;    
     sp->hash = hash;    
     sp->count = 0;   
+    sp->cursor = 0;
+#ifdef SET_STATS
+    memset(&sp->stats, 0, sizeof(sp->stats));
+#endif
     sp->length = maxElts / ALPHA; 
     sp->lists = malloc(sizeof(LIST*) * sp->length);
     assert(sp->lists != NULL);
@@ -62,6 +124,10 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
 void destroySet(SET *sp)
 {
     assert(sp != NULL);
+#ifdef SET_STATS
+    if (getenv("SET_STATS") != NULL)
+        dumpStats(sp);
+#endif
     for (int i = 0; i < sp->length; i++)
         destroyList(sp->lists[i]);
     free(sp->lists);
@@ -84,6 +150,7 @@ void addElement(SET *sp, void *elt)
 {
     assert(sp != NULL && elt != NULL);
     int index = (*sp->hash)(elt) % sp->length;
+    COUNT_SEARCH(sp, sp->lists[index], elt);
     if (findItem(sp->lists[index], elt) == NULL)
     {
         addFirst(sp->lists[index], elt);
@@ -98,6 +165,7 @@ void removeElement(SET *sp, void *elt)
 {
     assert(sp != NULL && elt != NULL);
     int index = (*sp->hash)(elt) % sp->length;
+    COUNT_SEARCH(sp, sp->lists[index], elt);
     if (findItem(sp->lists[index], elt) != NULL)
     {
         removeItem(sp->lists[index], elt);
@@ -105,6 +173,23 @@ void removeElement(SET *sp, void *elt)
     }
 }
 
+/* toggleElement: add elt to the set pointed to by sp if it is not present, or
+ * remove the equal element if it is, hashing once and walking the bucket once.
+ * On removal the removed element is stored in *removed and NULL is returned. On
+ * insertion the address of the new element is returned so the caller can replace
+ * elt with an equal element it owns.
+ * Big O: O(1) average case, O(n) worst case where n is total elements
+ */
+void **toggleElement(SET *sp, void *elt, void **removed)
+{
+    assert(sp != NULL && elt != NULL && removed != NULL);
+    int index = (*sp->hash)(elt) % sp->length;
+    COUNT_SEARCH(sp, sp->lists[index], elt);
+    void **slot = toggleItem(sp->lists[index], elt, removed);
+    sp->count += slot != NULL ? 1 : -1;
+    return slot;
+}
+
 /* findElement: if elt is present in the set pointed to by sp then return the
  * matching element, otherwise return NULL.
  * Big O: O(1) average case, O(n) worst case where n is total elements
@@ -113,7 +198,8 @@ void *findElement(SET *sp, void *elt)
 {
     assert(sp != NULL && elt != NULL);
     int index = (*sp->hash)(elt) % sp->length;
-    return findItem(sp->lists[index], elt); 
+    COUNT_SEARCH(sp, sp->lists[index], elt);
+    return findItem(sp->lists[index], elt);
 }
 
 /* getElements: allocate and return an array of all elements in the set pointed to by sp.
@@ -137,4 +223,58 @@ void *getElements(SET *sp)
         }
     }
     return copy; 
-}
\ No newline at end of file
+}
+
+/* firstElement: start an iteration over the set pointed to by sp and return its
+ * first element, or NULL if the set is empty. Each list is walked in place
+ * with firstItem and nextItem, so nothing is allocated. The set must not be
+ * changed until nextElement returns NULL.
+ * Big O: O(m) worst case where m is the number of lists
+ */
+void *firstElement(SET *sp)
+{
+    assert(sp != NULL);
+    for (sp->cursor = 0; sp->cursor < sp->length; sp->cursor++)
+    {
+        void *elt = firstItem(sp->lists[sp->cursor]);
+        if (elt != NULL)
+            return elt;
+    }
+    return NULL;
+}
+
+/* nextElement: return the next element of the iteration started by firstElement,
+ * or NULL once every element has been returned.
+ * Big O: O(m) worst case, O(n + m) for a whole iteration
+ */
+void *nextElement(SET *sp)
+{
+    assert(sp != NULL);
+    if (sp->cursor >= sp->length)
+        return NULL;
+    void *elt = nextItem(sp->lists[sp->cursor]);
+    while (elt == NULL && ++sp->cursor < sp->length)
+        elt = firstItem(sp->lists[sp->cursor]);
+    return elt;
+}
+
+#ifdef SET_STATS
+/* getSetStats: store the statistics of the set pointed to by sp in *stats. The
+ * slot bytes cover the array of lists and every list's nodes, and the elements
+ * belong to the caller, so no key bytes or rehashes are reported.
+ * Big O: O(m) where m is the number of lists
+ */
+void getSetStats(SET *sp, struct setstats *stats)
+{
+    assert(sp != NULL && stats != NULL);
+    *stats = sp->stats;
+    stats->live = sp->count;
+    stats->slotBytes = sizeof(LIST*) * sp->length;
+    for (int i = 0; i < sp->length; i++)
+    {
+        if (numItems(sp->lists[i]) == 0)
+            stats->empty++;
+        stats->slotBytes += listBytes(sp->lists[i]);
+    }
+}
+#endif
@@ -53,7 +53,7 @@ static unsigned strhash(char *s)
 int main(int argc, char *argv[])
 {
     FILE *fp;
-    char buffer[BUFSIZ], **elts, *word;
+    char buffer[BUFSIZ], *word;
     SET *unique;
     int i, words;
     bool lflag = false;
@@ -126,14 +126,9 @@ int main(int argc, char *argv[])
 
     /* Print the list of words if desired. */
 
-    if (lflag) {
-	elts = getElements(unique);
-
-	for (i = 0; i < numElements(unique); i ++)
-	    printf("%s\n", elts[i]);
-
-	free(elts);
-    }
+    if (lflag)
+	for (word = firstElement(unique); word != NULL; word = nextElement(unique))
+	    printf("%s\n", word);
 
     destroySet(unique);
     exit(EXIT_SUCCESS);
@@ -0,0 +1,187 @@
+/*
+ * File:        filter.c
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for a blocked Bloom filter over hash values.
+ *
+ *              The filter is an array of 64 byte blocks, one cache line
+ *              each.  A hash value is mixed into 64 bits, some of which
+ *              choose a block and the rest of which choose PROBES bits
+ *              within it, so each check or insertion reads or writes a
+ *              single cache line.  With BITS_PER_ELT bits per element the
+ *              false positive rate at full capacity is around one percent.
+ */
+
+# include <stdlib.h>
+# include <string.h>
+# include <stdint.h>
+# include <assert.h>
+# include <stdbool.h>
+# include "filter.h"
+
+# define BLOCK_BITS   512	/* bits per block, one cache line */
+# define BITS_PER_ELT 12	/* bits per element at full capacity */
+# define PROBES       6		/* bits set per element */
+
+struct filter {
+    int blocks;			/* number of blocks */
+    uint64_t *bits;		/* BLOCK_BITS / 64 words per block */
+};
+
+
+/*
+ * Function:	mix
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return a 64 bit mix of HASH, using the finalizer of the
+ *		splitmix64 generator.
+ */
+
+static uint64_t mix(unsigned hash)
+{
+    uint64_t x = hash + 0x9e3779b97f4a7c15ull;
+
+
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+
+/*
+ * Function:	block
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return the first word of the block of the filter pointed to
+ *		by FP chosen by the high half of the mixed hash X.
+ */
+
+static uint64_t *block(FILTER *fp, uint64_t x)
+{
+    return fp->bits + ((x >> 32) * fp->blocks >> 32) * (BLOCK_BITS / 64);
+}
+
+
+/*
+ * Function:    createFilter
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Return a pointer to a new empty filter sized for MAXELTS
+ *		elements.
+ */
+
+FILTER *createFilter(int maxElts)
+{
+    FILTER *fp;
+
+
+    assert(maxElts > 0);
+
+    fp = malloc(sizeof(FILTER));
+    assert(fp != NULL);
+
+    fp->blocks = ((long) maxElts * BITS_PER_ELT + BLOCK_BITS - 1) / BLOCK_BITS;
+    fp->bits = aligned_alloc(64, fp->blocks * (BLOCK_BITS / 8));
+    assert(fp->bits != NULL);
+
+    clearFilter(fp);
+    return fp;
+}
+
+
+/*
+ * Function:    destroyFilter
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Deallocate memory associated with the filter pointed to by
+ *		FP.
+ */
+
+void destroyFilter(FILTER *fp)
+{
+    assert(fp != NULL);
+
+    free(fp->bits);
+    free(fp);
+}
+
+
+/*
+ * Function:    clearFilter
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Remove every hash value from the filter pointed to by FP.
+ */
+
+void clearFilter(FILTER *fp)
+{
+    assert(fp != NULL);
+    memset(fp->bits, 0, fp->blocks * (BLOCK_BITS / 8));
+}
+
+
+/*
+ * Function:    addToFilter
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Add HASH to the filter pointed to by FP.  The bits within
+ *		the block are taken nine at a time from a second mix of the
+ *		hash value.
+ */
+
+void addToFilter(FILTER *fp, unsigned hash)
+{
+    uint64_t x, y, *words;
+    int i, bit;
+
+
+    assert(fp != NULL);
+
+    x = mix(hash);
+    y = x * 0x9e3779b97f4a7c15ull;
+    words = block(fp, x);
+
+    for (i = 0; i < PROBES; i ++) {
+	bit = (y >> (9 * i)) & (BLOCK_BITS - 1);
+	words[bit / 64] |= 1ull << (bit % 64);
+    }
+}
+
+
+/*
+ * Function:    mayContain
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return false if HASH was definitely never added to the
+ *		filter pointed to by FP since it was last cleared, and true
+ *		if it may have been.
+ */
+
+bool mayContain(FILTER *fp, unsigned hash)
+{
+    uint64_t x, y, *words;
+    int i, bit;
+
+
+    assert(fp != NULL);
+
+    x = mix(hash);
+    y = x * 0x9e3779b97f4a7c15ull;
+    words = block(fp, x);
+
+    for (i = 0; i < PROBES; i ++) {
+	bit = (y >> (9 * i)) & (BLOCK_BITS - 1);
+
+	if ((words[bit / 64] & (1ull << (bit % 64))) == 0)
+	    return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,28 @@
+/*
+ * File:        filter.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for a blocked Bloom filter over hash values.
+ *              A filter can say that a hash value was definitely never
+ *              added, or that it may have been.  Values cannot be removed
+ *              except by clearing the whole filter.
+ */
+
+# ifndef FILTER_H
+# define FILTER_H
+
+# include <stdbool.h>
+
+typedef struct filter FILTER;
+
+FILTER *createFilter(int maxElts);
+
+void destroyFilter(FILTER *fp);
+
+void clearFilter(FILTER *fp);
+
+void addToFilter(FILTER *fp, unsigned hash);
+
+bool mayContain(FILTER *fp, unsigned hash);
+
+# endif /* FILTER_H */
@@ -0,0 +1,566 @@
+/*
+ * File:        robin.c
+ *
+ * Copyright:	2021, Darren C. Atkinson
+ *
+ * Description: This file contains the public and private function and type
+ *              definitions for a set abstract data type for generic
+ *              pointer types.  A set is an unordered collection of unique
+ *              elements.
+ *
+ *              This implementation uses a hash table with Robin Hood
+ *              linear probing.  Each slot records how far its element is
+ *              from its home slot, and an insertion takes the slot of any
+ *              element closer to home than itself, which keeps probe
+ *              lengths even.  Deletion shifts the following elements back
+ *              instead of leaving a marker, so the table never fills with
+ *              deleted slots no matter how many removals there are.
+ *
+ *              Once enableFilter is called, a Bloom filter of the hash
+ *              values of the elements answers most searches for absent
+ *              elements.  Since bits cannot be cleared, the filter is
+ *              rebuilt once enough elements have been removed.
+ */
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <assert.h>
+# include <stdbool.h>
+# include "set.h"
+# include "filter.h"
+
+# define EMPTY  -1
+
+struct set {
+    int count;                  /* number of elements in array */
+    int length;                 /* length of allocated array   */
+    void **data;                /* array of allocated elements */
+    int *dist;                  /* distance of each slot from home, or EMPTY */
+    int cursor;                 /* next slot to visit          */
+    int (*compare)();		/* comparison function         */
+    unsigned (*hash)();		/* hash function               */
+    FILTER *filter;		/* filter of hash values, or NULL */
+    int stale;			/* removals since filter was built */
+};
+
+
+/*
+ * Function:    partition
+ *
+ * Complexity:  O(n)
+ *
+ * Description: Partition the array around a pivot element. Elements smaller
+ *              than or equal to the pivot are placed to its left, and elements
+ *              greater than the pivot are placed to its right.
+ */
+static int partition(void **arr, int low, int high, int (*compare)()) {
+    void *pivot = arr[high];
+    int i = low - 1;
+    for (int j = low; j < high; j++) {
+        if ((compare(arr[j], pivot) <= 0))  {
+            i++;
+            void *temp = arr[i];
+            arr[i] = arr[j];
+            arr[j] = temp;
+        }
+    }
+
+    void *temp = arr[i + 1];
+    arr[i + 1] = arr[high];
+    arr[high] = temp;
+
+    return i + 1;
+}
+
+/*
+ * Function:    quickSort
+ *
+ * Complexity:  O(n log n) average case, O(n^2) worst case
+ *
+ * Description: Sort the array using the quicksort algorithm.
+ */
+static void quickSort(void** arr, int low, int high, int (*compare)()) {
+    if (low < high) {
+        int pi = partition(arr, low, high, compare);
+        quickSort(arr, low, pi - 1, compare);
+        quickSort(arr, pi + 1, high, compare);
+    }
+}
+
+/*
+ * Function:    search
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Return the location of ELT, whose hash value is HASH, in the
+ *		set pointed to by SP.  If the element is present, then
+ *		*FOUND is true.  If not present, then *FOUND is false and
+ *		the location is where ELT belongs, either an empty slot or
+ *		the first slot whose element is closer to its home than ELT
+ *		would be.  *DIST is set to the distance of the returned slot
+ *		from ELT's home.  Only elements at exactly that distance
+ *		share ELT's home, so only they are compared.
+ */
+
+static int search(SET *sp, void *elt, unsigned hash, int *dist, bool *found)
+{
+    int d, locn, start;
+
+
+    start = hash % sp->length;
+
+    for (d = 0; d < sp->length; d ++) {
+        locn = (start + d) % sp->length;
+
+        if (sp->dist[locn] < d) {
+            *dist = d;
+            *found = false;
+            return locn;
+
+        } else if (sp->dist[locn] == d &&
+		(*sp->compare)(sp->data[locn], elt) == 0) {
+            *dist = d;
+            *found = true;
+            return locn;
+        }
+    }
+
+    *found = false;
+    return -1;
+}
+
+
+/*
+ * Function:	buildFilter
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Clear the filter of the set pointed to by SP and add the
+ *		hash value of every element to it.
+ */
+
+static void buildFilter(SET *sp)
+{
+    int i;
+
+
+    clearFilter(sp->filter);
+
+    for (i = 0; i < sp->length; i ++)
+	if (sp->dist[i] != EMPTY)
+	    addToFilter(sp->filter, (*sp->hash)(sp->data[i]));
+
+    sp->stale = 0;
+}
+
+
+/*
+ * Function:	absent
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return true if the filter of the set pointed to by SP shows
+ *		that no element has the hash value HASH.
+ */
+
+static bool absent(SET *sp, unsigned hash)
+{
+    return sp->filter != NULL && !mayContain(sp->filter, hash);
+}
+
+
+/*
+ * Function:    insert
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Put ELT, whose hash value is HASH and which is not present,
+ *		in slot LOCN at distance D from its home, as found by search.
+ *		Each element it displaces is carried forward and reinserted
+ *		the same way until an empty slot is reached, so ELT itself
+ *		stays in slot LOCN.
+ */
+
+static void insert(SET *sp, void *elt, unsigned hash, int locn, int d)
+{
+    int temp;
+    void *carry;
+
+
+    assert(sp->count < sp->length);
+
+    if (sp->filter != NULL)
+	addToFilter(sp->filter, hash);
+
+    while (sp->dist[locn] != EMPTY) {
+	if (sp->dist[locn] < d) {
+	    carry = sp->data[locn];
+	    sp->data[locn] = elt;
+	    elt = carry;
+
+	    temp = sp->dist[locn];
+	    sp->dist[locn] = d;
+	    d = temp;
+	}
+
+	locn = (locn + 1) % sp->length;
+	d ++;
+    }
+
+    sp->data[locn] = elt;
+    sp->dist[locn] = d;
+    sp->count ++;
+}
+
+
+/*
+ * Function:    erase
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Empty slot LOCN.  Every following element that is not in
+ *		its home slot is shifted back by one until an empty slot or
+ *		an element at home is reached.  The removed element's bits
+ *		stay in the filter, so the filter is rebuilt once there have
+ *		been more removals since it was built than there are
+ *		elements, and more than a sixteenth of the slots, which
+ *		keeps the cost of rebuilding constant per removal.
+ */
+
+static void erase(SET *sp, int locn)
+{
+    int i, next;
+
+
+    next = (locn + 1) % sp->length;
+
+    for (i = 1; i < sp->length && sp->dist[next] > 0; i ++) {
+	sp->data[locn] = sp->data[next];
+	sp->dist[locn] = sp->dist[next] - 1;
+	locn = next;
+	next = (next + 1) % sp->length;
+    }
+
+    sp->dist[locn] = EMPTY;
+    sp->count --;
+
+    if (sp->filter != NULL && ++ sp->stale > sp->count &&
+	    sp->stale > sp->length / 16)
+	buildFilter(sp);
+}
+
+
+/*
+ * Function:    createSet
+ *
+ * Complexity:  O(m)
+ *
+ * Description: Return a pointer to a new set with a maximum capacity of
+ *		MAXELTS.
+ */
+
+SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
+{
+    int i;
+    SET *sp;
+
+
+    assert(compare != NULL && hash != NULL);
+
+    sp = malloc(sizeof(SET));
+    assert(sp != NULL);
+
+    sp->data = malloc(sizeof(char *) * maxElts);
+    assert(sp->data != NULL);
+
+    sp->dist = malloc(sizeof(int) * maxElts);
+    assert(sp->dist != NULL);
+
+    sp->compare = compare;
+    sp->hash = hash;
+    sp->length = maxElts;
+    sp->count = 0;
+    sp->cursor = 0;
+    sp->filter = NULL;
+    sp->stale = 0;
+
+    for (i = 0; i < maxElts; i ++)
+        sp->dist[i] = EMPTY;
+
+    return sp;
+}
+
+
+/*
+ * Function:    destroySet
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Deallocate memory associated with the set pointed to by SP.
+ *		The elements themselves are not deallocated since we did not
+ *		allocate them in the first place.
+ */
+
+void destroySet(SET *sp)
+{
+    assert(sp != NULL);
+
+    if (sp->filter != NULL)
+	destroyFilter(sp->filter);
+
+    free(sp->dist);
+    free(sp->data);
+    free(sp);
+}
+
+
+/*
+ * Function:    numElements
+ *
+ * Complexity:  O(1)
+ *
+ * Description: Return the number of elements in the set pointed to by SP.
+ */
+
+int numElements(SET *sp)
+{
+    assert(sp != NULL);
+    return sp->count;
+}
+
+
+/*
+ * Function:    addElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Add ELT to the set pointed to by SP.
+ */
+
+void addElement(SET *sp, void *elt)
+{
+    bool found;
+
+
+    upsertElement(sp, elt, &found);
+}
+
+
+/*
+ * Function:    upsertElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Find or insert ELT in the set pointed to by SP with a
+ *		single search.  If an equal element is present, then *FOUND
+ *		is true and the address of its slot is returned.  Otherwise
+ *		ELT is added, *FOUND is false, and the address of its new
+ *		slot is returned so that the caller can replace ELT with an
+ *		equal element of its own before the next operation.
+ */
+
+void **upsertElement(SET *sp, void *elt, bool *found)
+{
+    int d, locn;
+    unsigned hash;
+
+
+    assert(sp != NULL && elt != NULL && found != NULL);
+    hash = (*sp->hash)(elt);
+    locn = search(sp, elt, hash, &d, found);
+
+    if (!*found)
+	insert(sp, elt, hash, locn, d);
+
+    return &sp->data[locn];
+}
+
+
+/*
+ * Function:    toggleElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Add ELT to the set pointed to by SP if no equal element is
+ *		present, or remove the equal element if there is one, with
+ *		a single search.  On removal the removed element is stored
+ *		in *REMOVED and NULL is returned.  On insertion the address
+ *		of the new slot is returned, as in upsertElement.
+ */
+
+void **toggleElement(SET *sp, void *elt, void **removed)
+{
+    int d, locn;
+    bool found;
+    unsigned hash;
+
+
+    assert(sp != NULL && elt != NULL && removed != NULL);
+    hash = (*sp->hash)(elt);
+    locn = search(sp, elt, hash, &d, &found);
+
+    if (found) {
+	*removed = sp->data[locn];
+	erase(sp, locn);
+	return NULL;
+    }
+
+    insert(sp, elt, hash, locn, d);
+    return &sp->data[locn];
+}
+
+
+/*
+ * Function:    removeElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Remove ELT from the set pointed to by SP.  The table is not
+ *		searched if the filter shows that ELT is absent.
+ */
+
+void removeElement(SET *sp, void *elt)
+{
+    int d, locn;
+    bool found;
+    unsigned hash;
+
+
+    assert(sp != NULL && elt != NULL);
+    hash = (*sp->hash)(elt);
+
+    if (absent(sp, hash))
+	return;
+
+    locn = search(sp, elt, hash, &d, &found);
+
+    if (found)
+	erase(sp, locn);
+}
+
+
+/*
+ * Function:    findElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: If ELT is present in the set pointed to by SP then return
+ *		it, otherwise return NULL.  The table is not searched if the
+ *		filter shows that ELT is absent.
+ */
+
+void *findElement(SET *sp, void *elt)
+{
+    int d, locn;
+    bool found;
+    unsigned hash;
+
+
+    assert(sp != NULL && elt != NULL);
+    hash = (*sp->hash)(elt);
+
+    if (absent(sp, hash))
+	return NULL;
+
+    locn = search(sp, elt, hash, &d, &found);
+    return found ? sp->data[locn] : NULL;
+}
+
+
+/*
+ * Function:	enableFilter
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Put a Bloom filter sized for the capacity of the set pointed
+ *		to by SP in front of its table, and add every element to it.
+ *		From then on, findElement and removeElement skip the search
+ *		for most absent elements.
+ */
+
+void enableFilter(SET *sp)
+{
+    assert(sp != NULL);
+
+    if (sp->filter == NULL)
+	sp->filter = createFilter(sp->length);
+
+    buildFilter(sp);
+}
+
+
+/*
+ * Function:	getElements
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Allocate and return an array of elements in the set pointed
+ *		to by SP. Use quicksort algorithm to sort before returning.
+ */
+
+void *getElements(SET *sp)
+{
+    int i, j;
+    void **elts;
+
+    assert(sp != NULL);
+
+    elts = malloc(sizeof(void *) * sp->count);
+    assert(elts != NULL);
+
+    for (i = 0, j = 0; i < sp->length; i ++)
+	if (sp->dist[i] != EMPTY)
+	    elts[j ++] = sp->data[i];
+
+    quickSort(elts, 0, sp->count-1, sp->compare);
+
+    return elts;
+}
+
+
+/*
+ * Function:	firstElement
+ *
+ * Complexity:	O(m) worst case
+ *
+ * Description:	Start an iteration over the elements in the set pointed to
+ *		by SP and return the first element, or NULL if the set is
+ *		empty.  The elements are visited in place, in slot order
+ *		rather than sorted, without allocating.  The set must not
+ *		be changed until nextElement returns NULL.
+ */
+
+void *firstElement(SET *sp)
+{
+    assert(sp != NULL);
+
+    sp->cursor = 0;
+    return nextElement(sp);
+}
+
+
+/*
+ * Function:	nextElement
+ *
+ * Complexity:	O(m) worst case, O(m) for a whole iteration
+ *
+ * Description:	Return the next element of the iteration started by
+ *		firstElement, or NULL once every element has been returned.
+ */
+
+void *nextElement(SET *sp)
+{
+    int i;
+
+    assert(sp != NULL);
+
+    while (sp->cursor < sp->length) {
+	i = sp->cursor ++;
+
+	if (sp->dist[i] != EMPTY)
+	    return sp->data[i];
+    }
+
+    return NULL;
+}
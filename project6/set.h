@@ -12,6 +12,9 @@
 # ifndef SET_H
 # define SET_H
 
+# include <stdbool.h>
+# include <stddef.h>
+
 typedef struct set SET;
 
 SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)());
@@ -22,10 +25,49 @@ int numElements(SET *sp);
 
 void addElement(SET *sp, void *elt);
 
+void **upsertElement(SET *sp, void *elt, bool *found);
+
 void removeElement(SET *sp, void *elt);
 
+void **toggleElement(SET *sp, void *elt, void **removed);
+
 void *findElement(SET *sp, void *elt);
 
 void *getElements(SET *sp);
 
+void *firstElement(SET *sp);
+
+void *nextElement(SET *sp);
+
+/* Put a Bloom filter in front of the set, so that most searches for absent
+   elements do not touch the table.  Worth enabling before a run of lookups
+   that mostly miss. */
+
+void enableFilter(SET *sp);
+
+# ifdef SET_STATS
+
+/* Statistics kept when compiled with -DSET_STATS.  A probe length is the
+   number of slots examined after the home slot, and the last bucket of
+   each histogram also counts all longer probes.  Setting the SET_STATS
+   environment variable prints them to stderr when a set is destroyed. */
+
+# define STATS_BUCKETS 16
+
+struct setstats {
+    unsigned long hits[STATS_BUCKETS];	/* successful searches */
+    unsigned long misses[STATS_BUCKETS];/* unsuccessful searches */
+    size_t maxProbe;			/* longest probe seen */
+    size_t live;			/* slots holding an element */
+    size_t tombstones;			/* slots marked deleted */
+    size_t empty;			/* unused slots */
+    size_t rehashes;			/* times the table was grown or rebuilt */
+    size_t slotBytes;			/* bytes allocated for the table */
+    size_t keyBytes;			/* bytes allocated for keys it owns */
+};
+
+void getSetStats(SET *sp, struct setstats *stats);
+
+# endif /* SET_STATS */
+
 # endif /* SET_H */
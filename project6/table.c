@@ -12,6 +12,11 @@
  *              elements, with linear probing to resolve collisions.
  *              Insertion, deletion, and membership checks are all average
  *              case constant time.
+ *
+ *              Once enableFilter is called, a Bloom filter of the hash
+ *              values of the elements answers most searches for absent
+ *              elements.  Since bits cannot be cleared, the filter is
+ *              rebuilt once enough elements have been removed.
  */
 
 # include <stdio.h>
@@ -20,6 +25,7 @@
 # include <assert.h>
 # include <stdbool.h>
 # include "set.h"
+# include "filter.h"
 
 # define EMPTY   0
 # define FILLED  1
@@ -30,10 +36,76 @@ struct set {
     int length;                 /* length of allocated array   */
     void **data;                /* array of allocated elements */
     char *flags;                /* state of each slot in array */
+    int cursor;                 /* next slot to visit          */
     int (*compare)();		/* comparison function         */
     unsigned (*hash)();		/* hash function               */
+    FILTER *filter;		/* filter of hash values, or NULL */
+    int stale;			/* removals since filter was built */
+# ifdef SET_STATS
+    struct setstats stats;	/* counters for getSetStats    */
+# endif
 };
 
+# ifdef SET_STATS
+
+/*
+ * Function:	countProbe
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Count a search that examined PROBES slots after the home
+ *		slot in the histogram HIST of the set pointed to by SP.
+ */
+
+static void countProbe(SET *sp, unsigned long *hist, size_t probes)
+{
+    hist[probes < STATS_BUCKETS - 1 ? probes : STATS_BUCKETS - 1] ++;
+
+    if (probes > sp->stats.maxProbe)
+	sp->stats.maxProbe = probes;
+}
+
+
+/*
+ * Function:	dumpStats
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Print the statistics of the set pointed to by SP to stderr.
+ */
+
+static void dumpStats(SET *sp)
+{
+    struct setstats st;
+    int i;
+
+
+    getSetStats(sp, &st);
+    fprintf(stderr, "set: %zu live, %zu tombstones, %zu empty, %zu rehashes\n",
+	st.live, st.tombstones, st.empty, st.rehashes);
+    fprintf(stderr, "set: %zu slot bytes, %zu key bytes, longest probe %zu\n",
+	st.slotBytes, st.keyBytes, st.maxProbe);
+
+    fprintf(stderr, "set: hits by probe length:");
+
+    for (i = 0; i < STATS_BUCKETS; i ++)
+	fprintf(stderr, " %lu", st.hits[i]);
+
+    fprintf(stderr, "\nset: misses by probe length:");
+
+    for (i = 0; i < STATS_BUCKETS; i ++)
+	fprintf(stderr, " %lu", st.misses[i]);
+
+    fprintf(stderr, "\n");
+}
+
+# define COUNT_HIT(sp, probes) countProbe(sp, (sp)->stats.hits, probes)
+# define COUNT_MISS(sp, probes) countProbe(sp, (sp)->stats.misses, probes)
+# else
+# define COUNT_HIT(sp, probes)
+# define COUNT_MISS(sp, probes)
+# endif
+
 
 /*
  * Function:    partition
@@ -83,25 +155,26 @@ void quickSort(void** arr, int low, int high, int (*compare)()) {
  *
  * Complexity:  O(1) average case, O(n) worst case
  *
- * Description: Return the location of ELT in the set pointed to by SP.  If
- *		the element is present, then *FOUND is true.  If not
- *		present, then *FOUND is false.  The element is first hashed
- *		to its correct location.  Linear probing is used to examine
- *		subsequent locations.
+ * Description: Return the location of ELT, whose hash value is HASH, in the
+ *		set pointed to by SP.  If the element is present, then
+ *		*FOUND is true.  If not present, then *FOUND is false.  The
+ *		element is first hashed to its correct location.  Linear
+ *		probing is used to examine subsequent locations.
  */
 
-static int search(SET *sp, void *elt, bool *found)
+static int search(SET *sp, void *elt, unsigned hash, bool *found)
 {
     int available, i, locn, start;
 
 
     available = -1;
-    start = (*sp->hash)(elt) % sp->length;
+    start = hash % sp->length;
 
     for (i = 0; i < sp->length; i ++) {
         locn = (start + i) % sp->length;
 
         if (sp->flags[locn] == EMPTY) {
+	    COUNT_MISS(sp, i);
             *found = false;
             return available != -1 ? available : locn;
 
@@ -110,16 +183,102 @@ static int search(SET *sp, void *elt, bool *found)
 		available = locn;
 
         } else if ((*sp->compare)(sp->data[locn], elt) == 0) {
+	    COUNT_HIT(sp, i);
             *found = true;
             return locn;
         }
     }
 
+    COUNT_MISS(sp, i);
     *found = false;
     return available;
 }
 
 
+/*
+ * Function:	buildFilter
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Clear the filter of the set pointed to by SP and add the
+ *		hash value of every element to it.
+ */
+
+static void buildFilter(SET *sp)
+{
+    int i;
+
+
+    clearFilter(sp->filter);
+
+    for (i = 0; i < sp->length; i ++)
+	if (sp->flags[i] == FILLED)
+	    addToFilter(sp->filter, (*sp->hash)(sp->data[i]));
+
+    sp->stale = 0;
+}
+
+
+/*
+ * Function:	fill
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Store ELT, whose hash value is HASH, in slot LOCN of the
+ *		set pointed to by SP, and add it to the filter if any.
+ */
+
+static void fill(SET *sp, int locn, void *elt, unsigned hash)
+{
+    assert(sp->count < sp->length);
+
+    sp->data[locn] = elt;
+    sp->flags[locn] = FILLED;
+    sp->count ++;
+
+    if (sp->filter != NULL)
+	addToFilter(sp->filter, hash);
+}
+
+
+/*
+ * Function:	erase
+ *
+ * Complexity:	O(1) amortized
+ *
+ * Description:	Delete the element in slot LOCN of the set pointed to by
+ *		SP.  Its bits stay in the filter, so the filter is rebuilt
+ *		once there have been more removals since it was built than
+ *		there are elements, and more than a sixteenth of the slots,
+ *		which keeps the cost of rebuilding constant per removal.
+ */
+
+static void erase(SET *sp, int locn)
+{
+    sp->flags[locn] = DELETED;
+    sp->count --;
+
+    if (sp->filter != NULL && ++ sp->stale > sp->count &&
+	    sp->stale > sp->length / 16)
+	buildFilter(sp);
+}
+
+
+/*
+ * Function:	absent
+ *
+ * Complexity:	O(1)
+ *
+ * Description:	Return true if the filter of the set pointed to by SP shows
+ *		that no element has the hash value HASH.
+ */
+
+static bool absent(SET *sp, unsigned hash)
+{
+    return sp->filter != NULL && !mayContain(sp->filter, hash);
+}
+
+
 /*
  * Function:    createSet
  *
@@ -150,6 +309,12 @@ SET *createSet(int maxElts, int (*compare)(), unsigned (*hash)())
     sp->hash = hash;
     sp->length = maxElts;
     sp->count = 0;
+    sp->cursor = 0;
+    sp->filter = NULL;
+    sp->stale = 0;
+# ifdef SET_STATS
+    memset(&sp->stats, 0, sizeof(sp->stats));
+# endif
 
     for (i = 0; i < maxElts; i ++)
         sp->flags[i] = EMPTY;
@@ -173,6 +338,14 @@ void destroySet(SET *sp)
 {
     assert(sp != NULL);
 
+# ifdef SET_STATS
+    if (getenv("SET_STATS") != NULL)
+	dumpStats(sp);
+# endif
+
+    if (sp->filter != NULL)
+	destroyFilter(sp->filter);
+
     free(sp->flags);
     free(sp->data);
     free(sp);
@@ -206,18 +379,79 @@ void addElement(SET *sp, void *elt)
 {
     int locn;
     bool found;
+    unsigned hash;
 
 
     assert(sp != NULL && elt != NULL);
-    locn = search(sp, elt, &found);
+    hash = (*sp->hash)(elt);
+    locn = search(sp, elt, hash, &found);
+
+    if (!found)
+	fill(sp, locn, elt, hash);
+}
+
 
-    if (!found) {
-	assert(sp->count < sp->length);
+/*
+ * Function:    upsertElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Find or insert ELT in the set pointed to by SP with a
+ *		single search.  If an equal element is present, then *FOUND
+ *		is true and the address of its slot is returned.  Otherwise
+ *		ELT itself is added, *FOUND is false, and the address of its
+ *		new slot is returned so that the caller can replace ELT with
+ *		an equal element of its own before the next operation.
+ */
 
-	sp->data[locn] = elt;
-	sp->flags[locn] = FILLED;
-	sp->count ++;
+void **upsertElement(SET *sp, void *elt, bool *found)
+{
+    int locn;
+    unsigned hash;
+
+
+    assert(sp != NULL && elt != NULL && found != NULL);
+    hash = (*sp->hash)(elt);
+    locn = search(sp, elt, hash, found);
+
+    if (!*found)
+	fill(sp, locn, elt, hash);
+
+    return &sp->data[locn];
+}
+
+
+/*
+ * Function:    toggleElement
+ *
+ * Complexity:  O(1) average case, O(n) worst case
+ *
+ * Description: Add ELT to the set pointed to by SP if no equal element is
+ *		present, or remove the equal element if there is one, with
+ *		a single search.  On removal the removed element is stored
+ *		in *REMOVED and NULL is returned.  On insertion the address
+ *		of the new slot is returned, as in upsertElement.
+ */
+
+void **toggleElement(SET *sp, void *elt, void **removed)
+{
+    int locn;
+    bool found;
+    unsigned hash;
+
+
+    assert(sp != NULL && elt != NULL && removed != NULL);
+    hash = (*sp->hash)(elt);
+    locn = search(sp, elt, hash, &found);
+
+    if (found) {
+	*removed = sp->data[locn];
+	erase(sp, locn);
+	return NULL;
     }
+
+    fill(sp, locn, elt, hash);
+    return &sp->data[locn];
 }
 
 
@@ -227,22 +461,27 @@ void addElement(SET *sp, void *elt)
  * Complexity:  O(1) average case, O(n) worst case
  *
  * Description: Remove ELT from the set pointed to by SP.  A element is
- *		deleted by changing the state of its slot.
+ *		deleted by changing the state of its slot.  The table is not
+ *		searched if the filter shows that ELT is absent.
  */
 
 void removeElement(SET *sp, void *elt)
 {
     int locn;
     bool found;
+    unsigned hash;
 
 
     assert(sp != NULL && elt != NULL);
-    locn = search(sp, elt, &found);
+    hash = (*sp->hash)(elt);
 
-    if (found) {
-	sp->flags[locn] = DELETED;
-	sp->count --;
-    }
+    if (absent(sp, hash))
+	return;
+
+    locn = search(sp, elt, hash, &found);
+
+    if (found)
+	erase(sp, locn);
 }
 
 
@@ -252,22 +491,50 @@ void removeElement(SET *sp, void *elt)
  * Complexity:  O(1) average case, O(n) worst case
  *
  * Description: If ELT is present in the set pointed to by SP then return
- *		it, otherwise return NULL.
+ *		it, otherwise return NULL.  The table is not searched if the
+ *		filter shows that ELT is absent.
  */
 
 void *findElement(SET *sp, void *elt)
 {
     int locn;
     bool found;
+    unsigned hash;
 
 
     assert(sp != NULL && elt != NULL);
+    hash = (*sp->hash)(elt);
 
-    locn = search(sp, elt, &found);
+    if (absent(sp, hash))
+	return NULL;
+
+    locn = search(sp, elt, hash, &found);
     return found ? sp->data[locn] : NULL;
 }
 
 
+/*
+ * Function:	enableFilter
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Put a Bloom filter sized for the capacity of the set pointed
+ *		to by SP in front of its table, and add every element to it.
+ *		From then on, findElement and removeElement skip the search
+ *		for most absent elements.
+ */
+
+void enableFilter(SET *sp)
+{
+    assert(sp != NULL);
+
+    if (sp->filter == NULL)
+	sp->filter = createFilter(sp->length);
+
+    buildFilter(sp);
+}
+
+
 /*
  * Function:	getElements
  *
@@ -298,3 +565,83 @@ void *getElements(SET *sp)
 }
 
 
+/*
+ * Function:	firstElement
+ *
+ * Complexity:	O(m) worst case
+ *
+ * Description:	Start an iteration over the elements in the set pointed to
+ *		by SP and return the first element, or NULL if the set is
+ *		empty.  The elements are visited in place, in slot order
+ *		rather than sorted, without allocating.  The set must not
+ *		be changed until nextElement returns NULL.
+ */
+
+void *firstElement(SET *sp)
+{
+    assert(sp != NULL);
+
+    sp->cursor = 0;
+    return nextElement(sp);
+}
+
+
+/*
+ * Function:	nextElement
+ *
+ * Complexity:	O(m) worst case, O(m) for a whole iteration
+ *
+ * Description:	Return the next element of the iteration started by
+ *		firstElement, or NULL once every element has been returned.
+ */
+
+void *nextElement(SET *sp)
+{
+    int i;
+
+    assert(sp != NULL);
+
+    while (sp->cursor < sp->length) {
+	i = sp->cursor ++;
+
+	if (sp->flags[i] == FILLED)
+	    return sp->data[i];
+    }
+
+    return NULL;
+}
+
+
+# ifdef SET_STATS
+
+/*
+ * Function:	getSetStats
+ *
+ * Complexity:	O(m)
+ *
+ * Description:	Store the statistics of the set pointed to by SP in
+ *		*STATS.  The table never grows, and the elements belong to
+ *		the caller, so no rehashes or key bytes are reported.
+ */
+
+void getSetStats(SET *sp, struct setstats *stats)
+{
+    int i;
+
+
+    assert(sp != NULL && stats != NULL);
+
+    *stats = sp->stats;
+
+    for (i = 0; i < sp->length; i ++)
+	if (sp->flags[i] == FILLED)
+	    stats->live ++;
+	else if (sp->flags[i] == DELETED)
+	    stats->tombstones ++;
+	else
+	    stats->empty ++;
+
+    stats->slotBytes = sp->length * (sizeof(void *) + sizeof(char));
+}
+
+# endif
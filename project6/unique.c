@@ -54,9 +54,10 @@ int main(int argc, char *argv[])
 {
     FILE *fp;
     char buffer[BUFSIZ], **elts, *word;
+    void **slot;
     SET *unique;
     int i, words;
-    bool lflag = false;
+    bool found, lflag = false;
 
 
     /* Check usage and open the first file. */
@@ -87,8 +88,10 @@ int main(int argc, char *argv[])
 
     while (fscanf(fp, "%s", buffer) == 1) {
         words ++;
-	if (!findElement(unique, buffer))
-	    addElement(unique, strdup(buffer));
+	slot = upsertElement(unique, buffer, &found);
+
+	if (!found)
+	    *slot = strdup(buffer);
     }
 
     fclose(fp);
@@ -108,7 +111,10 @@ int main(int argc, char *argv[])
         }
 
 
-        /* Delete all words in the second file. */
+        /* Delete all words in the second file.  Most of them may not be
+	   in the set, so let the filter answer those. */
+
+	enableFilter(unique);
 
         while (fscanf(fp, "%s", buffer) == 1) {
 	    if ((word = findElement(unique, buffer)) != NULL) {